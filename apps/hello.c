@@ -0,0 +1,12 @@
+// apps/hello.c — aplicação de exemplo carregada como módulo multiboot
+#include "kapi.h"
+
+static int runs = 0; // .data/.bss: fica em quadros próprios, não no módulo
+
+int app_main(const struct kapi *k) {
+    if (k->version != KAPI_VERSION) return -1;
+    runs++;
+    k->write("[hello] ola do initrd!\n");
+    k->log("[hello] ola do initrd!\n");
+    return runs;
+}
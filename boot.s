@@ -8,13 +8,25 @@ BITS 32
 SECTION .multiboot
 align 4
 MB_MAGIC equ 0x1BADB002
+%ifdef MB_VIDEO
+MB_FLAGS equ 0x00000007 ; align + memory info + modo de vídeo
+%else
 MB_FLAGS equ 0x00000003 ; align + memory info
+%endif
 MB_CHECKSUM equ -(MB_MAGIC + MB_FLAGS)
 
 
 dd MB_MAGIC
 dd MB_FLAGS
 dd MB_CHECKSUM
+%ifdef MB_VIDEO
+; campos de endereço (não usados em ELF) + pedido de LFB 640x480x32
+dd 0, 0, 0, 0, 0
+dd 0 ; mode_type: framebuffer linear
+dd 640
+dd 480
+dd 32
+%endif
 
 
 SECTION .text
@@ -27,6 +39,9 @@ start:
 cli
 ; Pilha simples
 mov esp, stack_top
+; kernel_main(magic, multiboot_info*)
+push ebx
+push eax
 call kernel_main
 .hang:
 hlt
@@ -0,0 +1,210 @@
+// kernel/bench.c — medições com TSC, resultados na serial
+#include "bench.h"
+#include "fb.h"
+#include "fpu.h"
+#include "serial.h"
+#include "timer.h"
+#include "util.h"
+
+#define PIT_HZ 1193182
+#define CALIBRATE_MS 10
+#define FB_BENCH_ROUNDS 16
+#define TIMER_BENCH_COUNT 512
+#define FPU_BENCH_ROUNDS 256
+
+static uint32_t tsc_khz = 0;
+
+/* Divide 64/32 sem libgcc (não linkamos __udivdi3) */
+static uint64_t div64_32(uint64_t n, uint32_t d) {
+    uint32_t hi = (uint32_t)(n >> 32), lo = (uint32_t)n;
+    uint32_t qhi = hi / d, r = hi % d, qlo;
+    __asm__("divl %4" : "=a"(qlo), "=d"(r) : "a"(lo), "d"(r), "rm"(d));
+    return ((uint64_t)qhi << 32) | qlo;
+}
+
+void bench_init(void) {
+    /* Canal 2 em modo 0 com o gate controlado pela porta 0x61 (alto-falante desligado) */
+    uint8_t p61 = inb(0x61);
+    outb(0x61, (p61 & ~0x02) & ~0x01);
+    outb(0x43, 0xB0);
+    uint16_t count = PIT_HZ / (1000 / CALIBRATE_MS);
+    outb(0x42, count & 0xFF);
+    outb(0x42, count >> 8);
+
+    outb(0x61, (p61 & ~0x02) | 0x01); // sobe o gate: contagem começa
+    uint64_t t0 = rdtsc();
+    while (!(inb(0x61) & 0x20)) { }   // OUT2 sobe quando chega a zero
+    uint64_t t1 = rdtsc();
+    outb(0x61, p61);
+
+    tsc_khz = (uint32_t)(t1 - t0) / CALIBRATE_MS;
+    if (tsc_khz == 0) tsc_khz = 1;
+}
+
+uint32_t bench_tsc_khz(void) { return tsc_khz; }
+
+uint32_t bench_cycles_to_us(uint64_t cycles) {
+    uint32_t mhz = tsc_khz / 1000;
+    return (uint32_t)div64_32(cycles, mhz ? mhz : 1);
+}
+
+void bench_report(const char *name, uint32_t value, const char *unit) {
+    serial_write("BENCH ");
+    serial_write(name);
+    serial_putc(' ');
+    serial_write_dec(value);
+    serial_putc(' ');
+    serial_write(unit);
+    serial_putc('\n');
+}
+
+uint32_t bench_cycles_to_ns(uint64_t cycles) {
+    return (uint32_t)div64_32(cycles * 1000, tsc_khz / 1000 ? tsc_khz / 1000 : 1);
+}
+
+void bench_sample(struct bench_samples *s, uint64_t cycles) {
+    uint32_t c = (uint32_t)cycles;
+    s->total++;
+    if (c > s->max) s->max = c;
+    if (s->n < s->cap) {
+        s->buf[s->n++] = c;
+        return;
+    }
+    /* Cada medição fica com probabilidade cap/total */
+    s->rng = s->rng * 1103515245 + 12345;
+    uint32_t j = (s->rng >> 1) % s->total;
+    if (j < s->cap) s->buf[j] = c;
+}
+
+/* Shell sort: sem recursão e suficiente para alguns milhares de amostras */
+static void sort_u32(uint32_t *a, uint32_t n) {
+    for (uint32_t gap = n / 2; gap > 0; gap /= 2) {
+        for (uint32_t i = gap; i < n; i++) {
+            uint32_t v = a[i], j = i;
+            while (j >= gap && a[j - gap] > v) { a[j] = a[j - gap]; j -= gap; }
+            a[j] = v;
+        }
+    }
+}
+
+static void report_suffixed(const char *name, const char *suffix, uint32_t value) {
+    serial_write("BENCH ");
+    serial_write(name);
+    serial_write(suffix);
+    serial_putc(' ');
+    serial_write_dec(value);
+    serial_write(" ns\n");
+}
+
+void bench_report_percentiles(const char *name, struct bench_samples *s) {
+    if (s->n == 0) return;
+    if (s->total > s->n) {
+        serial_write("[bench] ");
+        serial_write(name);
+        serial_write(": buffer cheio, percentis sobre ");
+        serial_write_dec(s->n);
+        serial_write(" de ");
+        serial_write_dec(s->total);
+        serial_write(" medicoes\n");
+    }
+    sort_u32(s->buf, s->n);
+    report_suffixed(name, "_p50", bench_cycles_to_ns(s->buf[s->n * 50 / 100]));
+    report_suffixed(name, "_p90", bench_cycles_to_ns(s->buf[s->n * 90 / 100]));
+    report_suffixed(name, "_p99", bench_cycles_to_ns(s->buf[s->n * 99 / 100]));
+    report_suffixed(name, "_max", bench_cycles_to_ns(s->max));
+}
+
+/* Cada contexto guarda um contador em st(0); só sobrevive às trocas se o
+   #NM salvar e restaurar o estado certo */
+static inline void fpu_count_start(void) { __asm__ volatile("fldz"); }
+static inline void fpu_count_inc(void) { __asm__ volatile("fld1\n faddp"); }
+static inline uint32_t fpu_count_end(void) {
+    uint32_t v;
+    __asm__ volatile("fistpl %0" : "=m"(v));
+    return v;
+}
+
+void bench_fpu(void) {
+    if (!fpu_present()) return;
+    static struct fpu_ctx a, b;
+    struct fpu_ctx *prev = fpu_current();
+    struct fpu_stats before = *fpu_get_stats();
+
+    fpu_switch(&a); fpu_count_start();
+    fpu_switch(&b); fpu_count_start();
+    uint64_t t0 = rdtsc();
+    for (int i = 0; i < FPU_BENCH_ROUNDS; i++) {
+        fpu_switch(&a); fpu_count_inc();
+        fpu_switch(&b); fpu_count_inc(); fpu_count_inc();
+    }
+    uint64_t t1 = rdtsc();
+    fpu_switch(&a); uint32_t ca = fpu_count_end();
+    fpu_switch(&b); uint32_t cb = fpu_count_end();
+
+    fpu_release(&a);
+    fpu_release(&b);
+    fpu_switch(prev);
+
+    const struct fpu_stats *st = fpu_get_stats();
+    bench_report("fpu_switch", (uint32_t)(t1 - t0) / (2 * FPU_BENCH_ROUNDS), "cycles");
+    bench_report("fpu_state_ok", ca == FPU_BENCH_ROUNDS && cb == 2 * FPU_BENCH_ROUNDS, "bool");
+    bench_report("fpu_nm_traps", st->nm_traps - before.nm_traps, "traps");
+    bench_report("fpu_saves", st->saves - before.saves, "saves");
+    bench_report("fpu_restores", st->restores - before.restores, "restores");
+    bench_report("fpu_allocs", st->allocs - before.allocs, "areas");
+}
+
+static uint32_t kpix_per_s(uint64_t pixels, uint64_t cycles) {
+    uint32_t us = bench_cycles_to_us(cycles);
+    return (uint32_t)div64_32(pixels * 1000, us ? us : 1);
+}
+
+static void bench_present(const char *name) {
+    struct fb_surface *back = fb_backbuffer();
+    uint64_t pixels = 0;
+    uint64_t t0 = rdtsc();
+    for (int i = 0; i < FB_BENCH_ROUNDS; i++) {
+        fb_mark_dirty(0, 0, back->width, back->height);
+        fb_present();
+        pixels += (uint32_t)back->width * back->height;
+    }
+    bench_report(name, kpix_per_s(pixels, rdtsc() - t0), "kpix/s");
+}
+
+void bench_fb(void) {
+    struct fb_surface *back = fb_backbuffer();
+    uint64_t pixels = 0;
+
+    uint64_t t0 = rdtsc();
+    for (int i = 0; i < FB_BENCH_ROUNDS; i++) {
+        fb_fill(back, 0, 0, back->width, back->height, (i & 1) ? 0x202020 : 0x000000);
+        pixels += (uint32_t)back->width * back->height;
+    }
+    bench_report("fb_fill_stosd", kpix_per_s(pixels, rdtsc() - t0), "kpix/s");
+
+    fb_use_sse2(0);
+    bench_present("fb_present_movsd");
+    if (fb_use_sse2(1)) bench_present("fb_present_sse2");
+}
+
+static void bench_timer_nop(struct timer *t, void *arg) { (void)t; (void)arg; }
+
+void bench_timers(void) {
+    static struct timer timers[TIMER_BENCH_COUNT];
+    uint32_t seed = 12345;
+
+    for (int i = 0; i < TIMER_BENCH_COUNT; i++) timer_setup(&timers[i], bench_timer_nop, 0);
+
+    uint64_t t0 = rdtsc();
+    for (int i = 0; i < TIMER_BENCH_COUNT; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t delay = 1 + ((seed >> 8) & ((1u << (8 + 6 * (i & 3))) - 1)); // 4 níveis
+        timer_arm(&timers[i], delay, 0);
+    }
+    uint64_t t1 = rdtsc();
+    for (int i = 0; i < TIMER_BENCH_COUNT; i++) timer_cancel(&timers[i]);
+    uint64_t t2 = rdtsc();
+
+    bench_report("timer_arm", (uint32_t)(t1 - t0) / TIMER_BENCH_COUNT, "cycles");
+    bench_report("timer_cancel", (uint32_t)(t2 - t1) / TIMER_BENCH_COUNT, "cycles");
+}
@@ -0,0 +1,41 @@
+#ifndef BENCH_H
+#define BENCH_H
+#include <stdint.h>
+
+/* Calibra o TSC contra o PIT (canal 2); precisa rodar uma vez antes das medições */
+void bench_init(void);
+
+uint32_t bench_tsc_khz(void);
+uint32_t bench_cycles_to_us(uint64_t cycles);
+uint32_t bench_cycles_to_ns(uint64_t cycles);
+
+/* Amostras de duração (ciclos) para percentis; o buffer é do chamador.
+   total e max contam todas as medições, mesmo depois que o buffer enche. */
+struct bench_samples {
+    uint32_t *buf;
+    uint32_t cap, n;
+    uint32_t total, max;
+    uint32_t rng;
+};
+
+/* Com o buffer cheio segue por amostragem de reservatório: os percentis
+   continuam cobrindo a execução inteira, não só o começo */
+void bench_sample(struct bench_samples *s, uint64_t cycles);
+
+/* Ordena as amostras e imprime <nome>_p50/_p90/_p99/_max em ns; avisa na
+   serial se nem todas as medições couberam no buffer */
+void bench_report_percentiles(const char *name, struct bench_samples *s);
+
+/* Dois contextos alternados com fpu_switch: custo da troca lazy e contadores do #NM */
+void bench_fpu(void);
+
+/* Imprime "BENCH <nome> <valor> <unidade>" na serial (formato lido pelo make report) */
+void bench_report(const char *name, uint32_t value, const char *unit);
+
+/* Vazão de fill e de cópia para o LFB (rep movsd x SSE2), em kpixels/s */
+void bench_fb(void);
+
+/* Custo de timer_arm/timer_cancel com prazos espalhados por todos os níveis da roda */
+void bench_timers(void);
+
+#endif
@@ -0,0 +1,131 @@
+// kernel/elf.c — carregador ELF32 com mapeamento sem cópia dos segmentos só leitura
+#include "elf.h"
+#include "paging.h"
+#include "util.h"
+
+#define EI_NIDENT 16
+#define ET_EXEC   2
+#define EM_386    3
+#define PT_LOAD   1
+#define PF_W      0x2
+
+struct elf32_ehdr {
+    uint8_t  e_ident[EI_NIDENT];
+    uint16_t e_type, e_machine;
+    uint32_t e_version, e_entry, e_phoff, e_shoff, e_flags;
+    uint16_t e_ehsize, e_phentsize, e_phnum, e_shentsize, e_shnum, e_shstrndx;
+} __attribute__((packed));
+
+struct elf32_phdr {
+    uint32_t p_type, p_offset, p_vaddr, p_paddr, p_filesz, p_memsz, p_flags, p_align;
+} __attribute__((packed));
+
+static inline uint32_t page_down(uint32_t a) { return a & ~(PAGE_SIZE - 1); }
+static inline uint32_t page_up(uint32_t a) { return (a + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1); }
+
+static int check_header(const uint8_t *image, uint32_t size) {
+    const struct elf32_ehdr *eh = (const struct elf32_ehdr*)image;
+    if (size < sizeof(*eh)) return 0;
+    if (image[0] != 0x7F || image[1] != 'E' || image[2] != 'L' || image[3] != 'F') return 0;
+    if (image[4] != 1 || image[5] != 1) return 0; // ELFCLASS32, little endian
+    if (eh->e_type != ET_EXEC || eh->e_machine != EM_386) return 0;
+    if (eh->e_phentsize != sizeof(struct elf32_phdr)) return 0;
+    if (eh->e_phoff > size || eh->e_phnum * sizeof(struct elf32_phdr) > size - eh->e_phoff) return 0;
+    return 1;
+}
+
+static int overlaps(const struct elf_image *img, uint32_t start, uint32_t end) {
+    for (int i = 0; i < img->nsegs; i++) {
+        uint32_t s = img->segs[i].vaddr, e = s + img->segs[i].pages * PAGE_SIZE;
+        if (start < e && s < end) return 1;
+    }
+    return 0;
+}
+
+/* text/rodata: as páginas do próprio módulo viram as páginas do segmento */
+static int map_shared(struct elf_image *img, const uint8_t *image, const struct elf32_phdr *ph) {
+    uint32_t va = page_down(ph->p_vaddr);
+    uint32_t pa = page_down((uint32_t)image + ph->p_offset);
+    uint32_t pages = (page_up(ph->p_vaddr + ph->p_memsz) - va) / PAGE_SIZE;
+    for (uint32_t i = 0; i < pages; i++) {
+        if (!paging_map(va + i * PAGE_SIZE, pa + i * PAGE_SIZE, 0)) return ELF_ERR_NOMEM;
+        img->segs[img->nsegs].pages = i + 1;
+    }
+    img->pages_shared += pages;
+    return ELF_OK;
+}
+
+/* .data/.bss: quadros novos, zerados, com a parte do arquivo copiada */
+static int map_owned(struct elf_image *img, const uint8_t *image, const struct elf32_phdr *ph) {
+    uint32_t va = page_down(ph->p_vaddr);
+    uint32_t pages = (page_up(ph->p_vaddr + ph->p_memsz) - va) / PAGE_SIZE;
+    for (uint32_t i = 0; i < pages; i++) {
+        uint32_t frame = frame_alloc();
+        if (!frame) return ELF_ERR_NOMEM;
+        memset((void*)frame, 0, PAGE_SIZE);
+        if (!paging_map(va + i * PAGE_SIZE, frame, PAGE_WRITE)) {
+            frame_free(frame);
+            return ELF_ERR_NOMEM;
+        }
+        img->segs[img->nsegs].pages = i + 1;
+    }
+    memcpy((void*)ph->p_vaddr, image + ph->p_offset, ph->p_filesz);
+    img->pages_owned += pages;
+    img->bytes_copied += ph->p_filesz;
+    return ELF_OK;
+}
+
+int elf_load(const uint8_t *image, uint32_t size, struct elf_image *out) {
+    memset(out, 0, sizeof(*out));
+    if (!check_header(image, size)) return ELF_ERR_FORMAT; // primeiro: módulos de dados só são ignorados
+    if (!paging_enabled()) return ELF_ERR_PAGING;
+
+    const struct elf32_ehdr *eh = (const struct elf32_ehdr*)image;
+    const struct elf32_phdr *phs = (const struct elf32_phdr*)(image + eh->e_phoff);
+
+    for (int i = 0; i < eh->e_phnum; i++) {
+        const struct elf32_phdr *ph = &phs[i];
+        if (ph->p_type != PT_LOAD || ph->p_memsz == 0) continue;
+
+        uint32_t start = page_down(ph->p_vaddr);
+        uint32_t end = page_up(ph->p_vaddr + ph->p_memsz);
+        int err = ELF_OK;
+        if (out->nsegs == ELF_MAX_SEGMENTS || ph->p_filesz > ph->p_memsz ||
+            ph->p_offset > size || ph->p_filesz > size - ph->p_offset ||
+            start < ELF_APP_BASE || end > ELF_APP_END || end <= start || overlaps(out, start, end))
+            err = ELF_ERR_RANGE;
+        else if ((ph->p_vaddr ^ ph->p_offset) & (PAGE_SIZE - 1))
+            err = ELF_ERR_ALIGN;
+        if (err) { elf_unload(out); return err; }
+
+        out->segs[out->nsegs].vaddr = start;
+        out->segs[out->nsegs].pages = 0;
+        /* Só dá para compartilhar se o segmento não tem .bss a zerar e o
+           módulo está alinhado em página (flag 0 do cabeçalho multiboot) */
+        int shared = !(ph->p_flags & PF_W) && ph->p_filesz == ph->p_memsz &&
+                     ((uint32_t)image & (PAGE_SIZE - 1)) == 0;
+        out->segs[out->nsegs].owned = !shared;
+        err = shared ? map_shared(out, image, ph) : map_owned(out, image, ph);
+        out->nsegs++;
+        if (err) { elf_unload(out); return err; }
+    }
+
+    if (out->nsegs == 0 || eh->e_entry < ELF_APP_BASE || eh->e_entry >= ELF_APP_END) {
+        elf_unload(out);
+        return ELF_ERR_FORMAT;
+    }
+    out->entry = eh->e_entry;
+    return ELF_OK;
+}
+
+void elf_unload(struct elf_image *img) {
+    for (int i = 0; i < img->nsegs; i++) {
+        struct elf_segment *s = &img->segs[i];
+        for (uint32_t p = 0; p < s->pages; p++) {
+            uint32_t va = s->vaddr + p * PAGE_SIZE;
+            if (s->owned) frame_free(paging_lookup(va)); // páginas do módulo não são nossas
+            paging_unmap(va);
+        }
+    }
+    img->nsegs = 0;
+}
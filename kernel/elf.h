@@ -0,0 +1,42 @@
+#ifndef ELF_H
+#define ELF_H
+#include <stdint.h>
+
+/* Janela virtual onde as aplicações são linkadas (apps/app.ld) */
+#define ELF_APP_BASE 0x40000000u
+#define ELF_APP_END  0x80000000u
+
+#define ELF_MAX_SEGMENTS 8
+
+/* Erros de elf_load */
+#define ELF_OK          0
+#define ELF_ERR_FORMAT  -1 // não é ELF32 i386 executável
+#define ELF_ERR_RANGE   -2 // segmento fora da janela ou sobreposto
+#define ELF_ERR_ALIGN   -3 // offset/vaddr não congruentes módulo 4KB
+#define ELF_ERR_NOMEM   -4 // faltaram quadros
+#define ELF_ERR_PAGING  -5 // paginação desligada
+
+struct elf_segment {
+    uint32_t vaddr;   // início alinhado em página
+    uint32_t pages;
+    int owned;        // 1 se os quadros foram alocados (.data/.bss)
+};
+
+struct elf_image {
+    uint32_t entry;
+    int nsegs;
+    struct elf_segment segs[ELF_MAX_SEGMENTS];
+    uint32_t pages_shared;  // páginas mapeadas direto do módulo
+    uint32_t pages_owned;   // páginas alocadas para dados graváveis
+    uint32_t bytes_copied;
+};
+
+/* Carrega um ELF32 que está num módulo já alinhado em página: segmentos só
+   leitura (text/rodata) são mapeados direto das páginas do módulo; só os
+   graváveis ganham quadros novos. */
+int elf_load(const uint8_t *image, uint32_t size, struct elf_image *out);
+
+/* Desfaz os mapeamentos e devolve os quadros alocados */
+void elf_unload(struct elf_image *img);
+
+#endif
@@ -0,0 +1,291 @@
+// kernel/fb.c — framebuffer linear 32bpp: detecção, back buffer, fill/blit e retângulos sujos
+#include "fb.h"
+#include "fpu.h"
+#include "util.h"
+
+/* Interface VBE "dispi" do Bochs/QEMU (-vga std), sem precisar de BIOS */
+#define VBE_DISPI_IOPORT_INDEX 0x01CE
+#define VBE_DISPI_IOPORT_DATA  0x01CF
+#define VBE_DISPI_INDEX_ID     0
+#define VBE_DISPI_INDEX_XRES   1
+#define VBE_DISPI_INDEX_YRES   2
+#define VBE_DISPI_INDEX_BPP    3
+#define VBE_DISPI_INDEX_ENABLE 4
+#define VBE_DISPI_ID2          0xB0C2 // primeira versão com 32bpp
+#define VBE_DISPI_ENABLED      0x01
+#define VBE_DISPI_LFB_ENABLED  0x40
+#define VBE_DISPI_LFB_DEFAULT  0xE0000000
+
+/* Placa VGA do Bochs/QEMU no PCI; o BAR0 é o LFB */
+#define BOCHS_VGA_PCI_ID 0x11111234
+
+/* Back buffer estático (não há heap); modos maiores são recortados */
+#define FB_MAX_WIDTH  1024
+#define FB_MAX_HEIGHT 768
+
+enum { FB_NONE, FB_MULTIBOOT, FB_DISPI };
+
+static int fb_mode = FB_NONE;
+static int fb_active = 0;
+static uint32_t lfb_addr;
+static int lfb_width, lfb_height, lfb_pitch; // pitch em pixels
+
+static uint32_t back_pixels[FB_MAX_WIDTH * FB_MAX_HEIGHT] __attribute__((aligned(16)));
+static struct fb_surface back, screen;
+
+struct rect { int x0, y0, x1, y1; }; // x1/y1 exclusivos
+static struct rect dirty[FB_MAX_DIRTY];
+static int ndirty = 0;
+
+static struct fb_stats stats;
+
+/* ---------- cópia de linhas ---------- */
+
+typedef void (*copy_row_fn)(uint32_t *dst, const uint32_t *src, uint32_t n);
+
+static void copy_row_movsd(uint32_t *dst, const uint32_t *src, uint32_t n) {
+    __asm__ volatile("rep movsl" : "+D"(dst), "+S"(src), "+c"(n) : : "memory");
+}
+
+/* 64 bytes por iteração; destino alinhado em 16 e escrita não-temporal,
+   que não polui o cache ao escrever no LFB */
+__attribute__((target("sse2")))
+static void copy_row_sse2(uint32_t *dst, const uint32_t *src, uint32_t n) {
+    while (n && ((uint32_t)dst & 15)) { *dst++ = *src++; n--; }
+    uint32_t blocks = n / 16;
+    if (blocks) {
+        __asm__ volatile(
+            "1:\n"
+            "movdqu   (%1), %%xmm0\n"
+            "movdqu 16(%1), %%xmm1\n"
+            "movdqu 32(%1), %%xmm2\n"
+            "movdqu 48(%1), %%xmm3\n"
+            "movntdq %%xmm0,   (%0)\n"
+            "movntdq %%xmm1, 16(%0)\n"
+            "movntdq %%xmm2, 32(%0)\n"
+            "movntdq %%xmm3, 48(%0)\n"
+            "add $64, %0\n"
+            "add $64, %1\n"
+            "dec %2\n"
+            "jnz 1b\n"
+            : "+r"(dst), "+r"(src), "+r"(blocks)
+            :
+            : "memory", "xmm0", "xmm1", "xmm2", "xmm3");
+    }
+    copy_row_movsd(dst, src, n & 15);
+}
+
+static copy_row_fn copy_row = copy_row_movsd;
+static int sse2_on = 0;
+
+/* Escritas não-temporais precisam de sfence antes de outro agente ler;
+   basta uma por fb_present, depois da cópia para o LFB */
+__attribute__((target("sse2")))
+static void sse2_fence(void) { __asm__ volatile("sfence" ::: "memory"); }
+
+static inline void copy_done(void) { if (sse2_on) sse2_fence(); }
+
+int fb_use_sse2(int on) {
+    sse2_on = on && fpu_has_sse2();
+    copy_row = sse2_on ? copy_row_sse2 : copy_row_movsd;
+    return sse2_on;
+}
+
+/* ---------- detecção ---------- */
+
+static void dispi_write(uint16_t index, uint16_t value) {
+    outw(VBE_DISPI_IOPORT_INDEX, index);
+    outw(VBE_DISPI_IOPORT_DATA, value);
+}
+
+static uint16_t dispi_read(uint16_t index) {
+    outw(VBE_DISPI_IOPORT_INDEX, index);
+    return inw(VBE_DISPI_IOPORT_DATA);
+}
+
+static uint32_t pci_read(uint8_t bus, uint8_t dev, uint8_t fn, uint8_t off) {
+    outl(0xCF8, 0x80000000u | ((uint32_t)bus << 16) | ((uint32_t)dev << 11) |
+                ((uint32_t)fn << 8) | (off & 0xFC));
+    return inl(0xCFC);
+}
+
+static uint32_t find_dispi_lfb(void) {
+    for (int dev = 0; dev < 32; dev++) {
+        if (pci_read(0, dev, 0, 0x00) == BOCHS_VGA_PCI_ID)
+            return pci_read(0, dev, 0, 0x10) & 0xFFFFFFF0;
+    }
+    return VBE_DISPI_LFB_DEFAULT;
+}
+
+static void setup_surfaces(void) {
+    screen.pixels = (uint32_t*)lfb_addr;
+    screen.width = lfb_width;
+    screen.height = lfb_height;
+    screen.pitch = lfb_pitch;
+
+    back.pixels = back_pixels;
+    back.width = lfb_width < FB_MAX_WIDTH ? lfb_width : FB_MAX_WIDTH;
+    back.height = lfb_height < FB_MAX_HEIGHT ? lfb_height : FB_MAX_HEIGHT;
+    back.pitch = back.width;
+}
+
+int fb_init(const struct multiboot_info *mbi) {
+    fb_use_sse2(1);
+
+    if (mbi && (mbi->flags & MULTIBOOT_INFO_FRAMEBUFFER) &&
+        mbi->framebuffer_type == MULTIBOOT_FRAMEBUFFER_TYPE_RGB &&
+        mbi->framebuffer_bpp == 32 && (mbi->framebuffer_addr >> 32) == 0) {
+        fb_mode = FB_MULTIBOOT;
+        fb_active = 1;
+        lfb_addr = (uint32_t)mbi->framebuffer_addr;
+        lfb_width = mbi->framebuffer_width;
+        lfb_height = mbi->framebuffer_height;
+        lfb_pitch = mbi->framebuffer_pitch / 4;
+        setup_surfaces();
+        return 1;
+    }
+
+    dispi_write(VBE_DISPI_INDEX_ID, VBE_DISPI_ID2);
+    uint16_t id = dispi_read(VBE_DISPI_INDEX_ID);
+    if ((id & 0xFFF0) == 0xB0C0 && id >= VBE_DISPI_ID2) {
+        fb_mode = FB_DISPI;
+        lfb_addr = find_dispi_lfb();
+        lfb_width = FB_WIDTH;
+        lfb_height = FB_HEIGHT;
+        lfb_pitch = FB_WIDTH;
+        setup_surfaces();
+        return 1;
+    }
+    return 0;
+}
+
+int fb_enter(void) {
+    if (fb_mode == FB_NONE) return 0;
+    if (fb_mode == FB_DISPI && !fb_active) {
+        dispi_write(VBE_DISPI_INDEX_ENABLE, 0);
+        dispi_write(VBE_DISPI_INDEX_XRES, FB_WIDTH);
+        dispi_write(VBE_DISPI_INDEX_YRES, FB_HEIGHT);
+        dispi_write(VBE_DISPI_INDEX_BPP, 32);
+        dispi_write(VBE_DISPI_INDEX_ENABLE, VBE_DISPI_ENABLED | VBE_DISPI_LFB_ENABLED);
+    }
+    fb_active = 1;
+    fb_fill(&back, 0, 0, back.width, back.height, 0);
+    fb_mark_dirty(0, 0, back.width, back.height);
+    fb_present();
+    return 1;
+}
+
+int fb_from_bootloader(void) { return fb_mode == FB_MULTIBOOT; }
+
+struct fb_surface *fb_backbuffer(void) { return &back; }
+
+/* ---------- fill / blit ---------- */
+
+/* Recorta (x,y,w,h) à superfície; retorna 0 se nada sobra */
+static int clip(const struct fb_surface *s, int *x, int *y, int *w, int *h) {
+    if (*x < 0) { *w += *x; *x = 0; }
+    if (*y < 0) { *h += *y; *y = 0; }
+    if (*x + *w > s->width) *w = s->width - *x;
+    if (*y + *h > s->height) *h = s->height - *y;
+    return *w > 0 && *h > 0;
+}
+
+void fb_fill(struct fb_surface *s, int x, int y, int w, int h, uint32_t color) {
+    if (!clip(s, &x, &y, &w, &h)) return;
+    uint32_t *row = s->pixels + y * s->pitch + x;
+    for (int j = 0; j < h; j++, row += s->pitch) {
+        uint32_t *d = row;
+        uint32_t n = w;
+        __asm__ volatile("rep stosl" : "+D"(d), "+c"(n) : "a"(color) : "memory");
+    }
+}
+
+void fb_blit(struct fb_surface *dst, int dx, int dy,
+             const struct fb_surface *src, int sx, int sy, int w, int h) {
+    /* Recorta contra a origem e depois contra o destino, mantendo o deslocamento */
+    int ox = sx, oy = sy;
+    if (!clip(src, &sx, &sy, &w, &h)) return;
+    dx += sx - ox; dy += sy - oy;
+    ox = dx; oy = dy;
+    if (!clip(dst, &dx, &dy, &w, &h)) return;
+    sx += dx - ox; sy += dy - oy;
+
+    uint32_t *d = dst->pixels + dy * dst->pitch + dx;
+    const uint32_t *s = src->pixels + sy * src->pitch + sx;
+    for (int j = 0; j < h; j++, d += dst->pitch, s += src->pitch)
+        copy_row(d, s, w);
+}
+
+/* ---------- retângulos sujos ---------- */
+
+static inline int rect_area(const struct rect *r) { return (r->x1 - r->x0) * (r->y1 - r->y0); }
+
+static inline struct rect rect_union(const struct rect *a, const struct rect *b) {
+    struct rect u;
+    u.x0 = a->x0 < b->x0 ? a->x0 : b->x0;
+    u.y0 = a->y0 < b->y0 ? a->y0 : b->y0;
+    u.x1 = a->x1 > b->x1 ? a->x1 : b->x1;
+    u.y1 = a->y1 > b->y1 ? a->y1 : b->y1;
+    return u;
+}
+
+static inline int rect_overlap(const struct rect *a, const struct rect *b) {
+    return a->x0 < b->x1 && b->x0 < a->x1 && a->y0 < b->y1 && b->y0 < a->y1;
+}
+
+/* Sobrepostos: separados, a interseção seria copiada duas vezes. Senão, só
+   se a união não cobre pixels a mais (lado a lado e alinhados); cantos que
+   se encostam ou vizinhos desalinhados ficam separados. */
+static inline int rect_should_merge(const struct rect *a, const struct rect *b) {
+    if (rect_overlap(a, b)) return 1;
+    struct rect u = rect_union(a, b);
+    return rect_area(&u) == rect_area(a) + rect_area(b);
+}
+
+void fb_mark_dirty(int x, int y, int w, int h) {
+    if (!clip(&back, &x, &y, &w, &h)) return;
+    struct rect r = { x, y, x + w, y + h };
+
+    for (;;) {
+        int i;
+        for (i = 0; i < ndirty; i++)
+            if (rect_should_merge(&dirty[i], &r)) break;
+
+        if (i == ndirty) {
+            if (ndirty < FB_MAX_DIRTY) {
+                dirty[ndirty++] = r;
+                return;
+            }
+            /* Lista cheia: funde com o retângulo que menos cresce */
+            int best_growth = 0x7FFFFFFF;
+            for (int j = 0; j < ndirty; j++) {
+                struct rect u = rect_union(&dirty[j], &r);
+                int growth = rect_area(&u) - rect_area(&dirty[j]);
+                if (growth < best_growth) { best_growth = growth; i = j; }
+            }
+        }
+
+        /* Tira o parceiro da lista e reavalia a união contra os demais */
+        r = rect_union(&dirty[i], &r);
+        dirty[i] = dirty[--ndirty];
+    }
+}
+
+void fb_present(void) {
+    if (!fb_active || ndirty == 0) return;
+    for (int i = 0; i < ndirty; i++) {
+        struct rect *r = &dirty[i];
+        int w = r->x1 - r->x0;
+        uint32_t *d = screen.pixels + r->y0 * screen.pitch + r->x0;
+        const uint32_t *s = back.pixels + r->y0 * back.pitch + r->x0;
+        for (int y = r->y0; y < r->y1; y++, d += screen.pitch, s += back.pitch)
+            copy_row(d, s, w);
+        stats.pixels += w * (r->y1 - r->y0);
+    }
+    copy_done();
+    stats.rects += ndirty;
+    stats.presents++;
+    ndirty = 0;
+}
+
+const struct fb_stats *fb_get_stats(void) { return &stats; }
@@ -0,0 +1,55 @@
+#ifndef FB_H
+#define FB_H
+#include <stdint.h>
+#include "multiboot.h"
+
+/* Modo pedido ao Bochs/QEMU VBE quando o bootloader não entrega framebuffer */
+#define FB_WIDTH  640
+#define FB_HEIGHT 480
+
+/* Máximo de retângulos sujos antes de começar a fundi-los */
+#define FB_MAX_DIRTY 32
+
+/* Superfície 32bpp (0x00RRGGBB); pitch em pixels */
+struct fb_surface {
+    uint32_t *pixels;
+    int width, height;
+    int pitch;
+};
+
+struct fb_stats {
+    uint32_t presents;        // chamadas a fb_present com algo sujo
+    uint32_t rects;           // retângulos copiados para o LFB
+    uint32_t pixels;          // pixels copiados para o LFB
+};
+
+/* Detecta um LFB: framebuffer do multiboot ou interface VBE dispi do Bochs/QEMU.
+   Retorna 1 se há framebuffer disponível. */
+int fb_init(const struct multiboot_info *mbi);
+
+/* Liga o modo gráfico (no caso dispi); não há volta para o modo texto */
+int fb_enter(void);
+
+/* 1 se o modo gráfico já veio ligado pelo bootloader (sem modo texto) */
+int fb_from_bootloader(void);
+
+struct fb_surface *fb_backbuffer(void);
+
+void fb_fill(struct fb_surface *s, int x, int y, int w, int h, uint32_t color);
+/* Com SSE2 a cópia é não-temporal e não tem sfence: feita para o back buffer,
+   cuja ida ao LFB (fb_present) termina com a barreira */
+void fb_blit(struct fb_surface *dst, int dx, int dy,
+             const struct fb_surface *src, int sx, int sy, int w, int h);
+
+/* Registra uma região alterada do back buffer */
+void fb_mark_dirty(int x, int y, int w, int h);
+
+/* Copia as regiões sujas do back buffer para o LFB */
+void fb_present(void);
+
+/* Escolhe a cópia com SSE2 (se disponível) ou rep movsd; retorna o estado efetivo */
+int fb_use_sse2(int on);
+
+const struct fb_stats *fb_get_stats(void);
+
+#endif
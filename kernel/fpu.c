@@ -0,0 +1,146 @@
+// kernel/fpu.c — x87/SSE com troca de contexto preguiçosa (CR0.TS + #NM)
+#include "fpu.h"
+#include "vga.h"
+#include "util.h"
+
+#define CR0_MP (1u << 1)
+#define CR0_EM (1u << 2)
+#define CR0_TS (1u << 3)
+#define CR0_NE (1u << 5)
+#define CR4_OSFXSR     (1u << 9)
+#define CR4_OSXMMEXCPT (1u << 10)
+
+#define CPUID_EDX_FPU  (1u << 0)
+#define CPUID_EDX_FXSR (1u << 24)
+#define CPUID_EDX_SSE  (1u << 25)
+#define CPUID_EDX_SSE2 (1u << 26)
+
+#define MXCSR_DEFAULT 0x1F80 // todas as exceções SIMD mascaradas
+
+static int has_fpu = 0, has_fxsr = 0, has_sse = 0, has_sse2 = 0;
+
+/* Pool estático de áreas (não há heap); 16 bytes de alinhamento para FXSAVE */
+static uint8_t area_pool[FPU_MAX_CTX][FPU_AREA_SIZE] __attribute__((aligned(FPU_AREA_ALIGN)));
+static uint8_t area_used[FPU_MAX_CTX];
+
+/* Contexto da thread inicial (kernel_main) */
+static struct fpu_ctx boot_ctx;
+static struct fpu_ctx *current = &boot_ctx; // thread em execução
+static struct fpu_ctx *owner = 0;           // thread cujo estado está nos registradores
+
+static struct fpu_stats stats;
+
+static inline uint32_t read_cr0(void) { uint32_t v; __asm__ volatile("mov %%cr0, %0" : "=r"(v)); return v; }
+static inline void write_cr0(uint32_t v) { __asm__ volatile("mov %0, %%cr0" : : "r"(v)); }
+static inline uint32_t read_cr4(void) { uint32_t v; __asm__ volatile("mov %%cr4, %0" : "=r"(v)); return v; }
+static inline void write_cr4(uint32_t v) { __asm__ volatile("mov %0, %%cr4" : : "r"(v)); }
+
+static inline void set_ts(void) { write_cr0(read_cr0() | CR0_TS); }
+static inline void clts(void) { __asm__ volatile("clts"); }
+
+static uint8_t *area_alloc(void) {
+    for (int i = 0; i < FPU_MAX_CTX; i++) {
+        if (!area_used[i]) {
+            area_used[i] = 1;
+            return area_pool[i];
+        }
+    }
+    return 0;
+}
+
+static void fpu_save(uint8_t *area) {
+    if (has_fxsr) __asm__ volatile("fxsave (%0)" : : "r"(area) : "memory");
+    else          __asm__ volatile("fnsave (%0)" : : "r"(area) : "memory");
+}
+
+static void fpu_restore(const uint8_t *area) {
+    if (has_fxsr) __asm__ volatile("fxrstor (%0)" : : "r"(area) : "memory");
+    else          __asm__ volatile("frstor (%0)" : : "r"(area) : "memory");
+}
+
+void fpu_init(void) {
+    if (cpuid_supported()) {
+        uint32_t a, b, c, d;
+        cpuid(1, &a, &b, &c, &d);
+        has_fpu  = (d & CPUID_EDX_FPU) != 0;
+        has_fxsr = (d & CPUID_EDX_FXSR) != 0;
+        has_sse  = has_fxsr && (d & CPUID_EDX_SSE);
+        has_sse2 = has_sse && (d & CPUID_EDX_SSE2);
+    }
+    if (!has_fpu) {
+        /* Sem FPU: mantém CR0.EM, qualquer instrução x87/SSE cai no #NM */
+        write_cr0(read_cr0() | CR0_EM);
+        return;
+    }
+
+    /* EM=0 (FPU real), MP=1 (WAIT respeita TS), NE=1 (erros via #MF, não IRQ13) */
+    uint32_t cr0 = read_cr0();
+    cr0 &= ~(CR0_EM | CR0_TS);
+    cr0 |= CR0_MP | CR0_NE;
+    write_cr0(cr0);
+    __asm__ volatile("fninit");
+
+    if (has_sse) write_cr4(read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+
+    /* Ninguém é dono dos registradores: o primeiro uso dispara #NM */
+    owner = 0;
+    set_ts();
+}
+
+int fpu_present(void) { return has_fpu; }
+int fpu_has_sse(void) { return has_sse; }
+int fpu_has_sse2(void) { return has_sse2; }
+
+void fpu_switch(struct fpu_ctx *next) {
+    current = next;
+    /* Se a próxima thread ainda é dona dos registradores, nada a fazer */
+    if (owner == next) clts();
+    else set_ts();
+}
+
+struct fpu_ctx *fpu_current(void) { return current; }
+
+void fpu_release(struct fpu_ctx *ctx) {
+    if (owner == ctx) owner = 0;
+    if (ctx->area) {
+        area_used[(ctx->area - &area_pool[0][0]) / FPU_AREA_SIZE] = 0;
+        ctx->area = 0;
+    }
+}
+
+void fpu_nm_handler(void) {
+    if (!has_fpu) {
+        vga_write("PANIC: instrucao x87/SSE sem FPU presente.\n");
+        for(;;) __asm__ volatile("hlt");
+    }
+
+    clts();
+    stats.nm_traps++;
+    if (owner == current) return;
+
+    if (owner) {
+        fpu_save(owner->area);
+        stats.saves++;
+    }
+
+    if (!current->area) {
+        /* Primeiro uso desta thread: reserva a área e começa com estado limpo */
+        current->area = area_alloc();
+        if (!current->area) {
+            vga_write("PANIC: sem areas de FPU livres.\n");
+            for(;;) __asm__ volatile("hlt");
+        }
+        stats.allocs++;
+        __asm__ volatile("fninit");
+        if (has_sse) {
+            uint32_t mxcsr = MXCSR_DEFAULT;
+            __asm__ volatile("ldmxcsr %0" : : "m"(mxcsr));
+        }
+    } else {
+        fpu_restore(current->area);
+        stats.restores++;
+    }
+    owner = current;
+}
+
+const struct fpu_stats *fpu_get_stats(void) { return &stats; }
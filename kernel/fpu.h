@@ -0,0 +1,48 @@
+#ifndef FPU_H
+#define FPU_H
+
+#include <stdint.h>
+
+/* Tamanho (e alinhamento exigido) da área usada por FXSAVE/FXRSTOR */
+#define FPU_AREA_SIZE  512
+#define FPU_AREA_ALIGN 16
+
+/* Quantas áreas de estado podem existir ao mesmo tempo (uma por thread) */
+#define FPU_MAX_CTX 16
+
+/* Estado de FPU/SSE de uma thread. A área só é reservada quando a thread
+   executa a primeira instrução x87/SSE (via #NM); threads que nunca usam
+   SIMD ficam com area == 0 e não custam nada na troca de contexto. */
+struct fpu_ctx {
+    uint8_t *area;
+};
+
+struct fpu_stats {
+    uint32_t nm_traps;  // quantas vezes o #NM disparou
+    uint32_t saves;     // FXSAVE do dono anterior
+    uint32_t restores;  // FXRSTOR do novo dono
+    uint32_t allocs;    // áreas reservadas sob demanda
+};
+
+/* Verifica CPUID, liga x87/SSE (CR0/CR4) e arma CR0.TS para o modo lazy */
+void fpu_init(void);
+
+int fpu_present(void);
+int fpu_has_sse(void);
+int fpu_has_sse2(void);
+
+/* Chamado pelo escalonador ao trocar de thread: só arma CR0.TS, não salva nada */
+void fpu_switch(struct fpu_ctx *next);
+
+/* Contexto em execução (para voltar a ele depois de um fpu_switch) */
+struct fpu_ctx *fpu_current(void);
+
+/* Libera a área de uma thread que terminou */
+void fpu_release(struct fpu_ctx *ctx);
+
+/* Handler do vetor 7 (#NM), chamado por isr_handler_c */
+void fpu_nm_handler(void);
+
+const struct fpu_stats *fpu_get_stats(void);
+
+#endif /* FPU_H */
@@ -0,0 +1,113 @@
+// kernel/gfx.c — grade de texto 80x25 desenhada com tiles sobre o framebuffer
+#include "gfx.h"
+#include "fb.h"
+#include "vga.h"
+#include "util.h"
+
+/* Paleta VGA de 16 cores em 0x00RRGGBB */
+static const uint32_t palette[16] = {
+    0x000000, 0x0000AA, 0x00AA00, 0x00AAAA, 0xAA0000, 0xAA00AA, 0xAA5500, 0xAAAAAA,
+    0x555555, 0x5555FF, 0x55FF55, 0x55FFFF, 0xFF5555, 0xFF55FF, 0xFFFF55, 0xFFFFFF,
+};
+
+static uint8_t font[256 * VGA_FONT_HEIGHT];
+static int have_font = 0;
+
+/* Cache de tiles: cada slot guarda um (char,cor) já rasterizado em 32bpp */
+static uint32_t tile_pixels[GFX_TILE_SLOTS][GFX_CELL_W * GFX_CELL_H] __attribute__((aligned(16)));
+static uint16_t tile_key[GFX_TILE_SLOTS];
+static uint8_t tile_valid[GFX_TILE_SLOTS];
+
+/* Grade pendente (escrita por gfx_putat) e grade já desenhada */
+static uint16_t cells[VGA_HEIGHT][VGA_WIDTH];
+static uint16_t drawn[VGA_HEIGHT][VGA_WIDTH];
+static int full_redraw = 1;
+static int origin_x = 0, origin_y = 0;
+
+static struct gfx_stats stats;
+
+static inline uint16_t cell_key(char c, uint8_t color) {
+    return (uint16_t)(uint8_t)c | ((uint16_t)color << 8);
+}
+
+static void rasterize(uint32_t *dst, uint16_t key) {
+    uint8_t c = key & 0xFF;
+    uint32_t fg = palette[(key >> 8) & 0x0F];
+    uint32_t bg = palette[(key >> 12) & 0x0F];
+    for (int y = 0; y < GFX_CELL_H; y++) {
+        uint8_t bits;
+        if (have_font) bits = font[c * VGA_FONT_HEIGHT + y];
+        else bits = (c != ' ' && y > 0 && y < GFX_CELL_H - 1) ? 0x7E : 0; // sem fonte: bloco
+        for (int x = 0; x < GFX_CELL_W; x++)
+            *dst++ = (bits & (0x80 >> x)) ? fg : bg;
+    }
+}
+
+static const uint32_t *tile_lookup(uint16_t key) {
+    uint32_t slot = ((uint32_t)key * 2654435761u) >> 24; // hash multiplicativo, 8 bits
+    if (tile_valid[slot] && tile_key[slot] == key) {
+        stats.tile_hits++;
+    } else {
+        rasterize(tile_pixels[slot], key);
+        tile_key[slot] = key;
+        tile_valid[slot] = 1;
+        stats.tile_misses++;
+    }
+    return tile_pixels[slot];
+}
+
+int gfx_init(const struct multiboot_info *mbi) {
+    if (!fb_init(mbi)) return 0;
+
+    /* Em modo texto a fonte da BIOS está no plano 2; num framebuffer vindo
+       do bootloader ela já não existe e os glifos viram blocos */
+    if (!fb_from_bootloader()) {
+        vga_font_read(font);
+        for (int i = 0; i < (int)sizeof(font); i++)
+            if (font[i]) { have_font = 1; break; }
+    }
+    return 1;
+}
+
+int gfx_enter(void) {
+    if (!fb_enter()) return 0;
+    struct fb_surface *back = fb_backbuffer();
+    origin_x = (back->width - VGA_WIDTH * GFX_CELL_W) / 2;
+    origin_y = (back->height - VGA_HEIGHT * GFX_CELL_H) / 2;
+    if (origin_x < 0) origin_x = 0;
+    if (origin_y < 0) origin_y = 0;
+    memset(cells, 0, sizeof(cells));
+    full_redraw = 1;
+    return 1;
+}
+
+void gfx_putat(char c, uint8_t color, int x, int y) {
+    if (x < 0 || x >= VGA_WIDTH || y < 0 || y >= VGA_HEIGHT) return;
+    cells[y][x] = cell_key(c, color);
+}
+
+void gfx_invalidate(void) { full_redraw = 1; }
+
+void gfx_present(void) {
+    struct fb_surface *back = fb_backbuffer();
+    struct fb_surface tile = { 0, GFX_CELL_W, GFX_CELL_H, GFX_CELL_W };
+
+    for (int y = 0; y < VGA_HEIGHT; y++) {
+        for (int x = 0; x < VGA_WIDTH; x++) {
+            uint16_t key = cells[y][x];
+            if (!full_redraw && drawn[y][x] == key) continue;
+            drawn[y][x] = key;
+
+            int px = origin_x + x * GFX_CELL_W;
+            int py = origin_y + y * GFX_CELL_H;
+            tile.pixels = (uint32_t*)tile_lookup(key);
+            fb_blit(back, px, py, &tile, 0, 0, GFX_CELL_W, GFX_CELL_H);
+            fb_mark_dirty(px, py, GFX_CELL_W, GFX_CELL_H);
+            stats.cells_drawn++;
+        }
+    }
+    full_redraw = 0;
+    fb_present();
+}
+
+const struct gfx_stats *gfx_get_stats(void) { return &stats; }
@@ -0,0 +1,36 @@
+#ifndef GFX_H
+#define GFX_H
+#include <stdint.h>
+#include "multiboot.h"
+
+/* Cada célula de texto vira um tile de 8x16 pixels */
+#define GFX_CELL_W 8
+#define GFX_CELL_H 16
+
+/* Slots do cache de tiles pré-rasterizados (mapeamento direto por (char,cor)) */
+#define GFX_TILE_SLOTS 256
+
+struct gfx_stats {
+    uint32_t tile_hits;    // tile já estava no cache
+    uint32_t tile_misses;  // tile rasterizado a partir da fonte
+    uint32_t cells_drawn;  // células efetivamente redesenhadas
+};
+
+/* Detecta o framebuffer e captura a fonte VGA (precisa rodar ainda em modo texto) */
+int gfx_init(const struct multiboot_info *mbi);
+
+/* Troca para o modo gráfico; a partir daqui a saída vai por gfx_putat */
+int gfx_enter(void);
+
+/* Mesma interface de vga_putat, mas só grava na grade pendente */
+void gfx_putat(char c, uint8_t color, int x, int y);
+
+/* Desenha as células que mudaram desde o último quadro e apresenta */
+void gfx_present(void);
+
+/* Força o redesenho de todas as células no próximo gfx_present */
+void gfx_invalidate(void);
+
+const struct gfx_stats *gfx_get_stats(void);
+
+#endif
@@ -0,0 +1,71 @@
+// kernel/initrd.c — módulos multiboot vistos como um initrd somente leitura
+#include "initrd.h"
+
+static struct initrd_file files[INITRD_MAX_FILES];
+static int nfiles = 0;
+static uint32_t end_addr = 0;
+
+static void note_end(uint32_t addr) { if (addr > end_addr) end_addr = addr; }
+
+/* "/boot/apps/hello.elf"      -> "hello.elf"
+   "/boot/apps/hello.elf app"  -> "app" */
+static void module_name(char *out, const char *cmdline) {
+    const char *start = cmdline, *p = cmdline;
+    const char *word = 0;
+    while (*p && *p != ' ') {
+        if (*p == '/') start = p + 1;
+        p++;
+    }
+    while (*p == ' ') p++;
+    if (*p) word = p;
+    if (word) start = word;
+
+    int n = 0;
+    while (start[n] && start[n] != ' ' && n < INITRD_NAME_MAX - 1) { out[n] = start[n]; n++; }
+    out[n] = 0;
+}
+
+static int name_eq(const char *a, const char *b) {
+    while (*a && *a == *b) { a++; b++; }
+    return *a == *b;
+}
+
+void initrd_init(const struct multiboot_info *mbi) {
+    nfiles = 0;
+    if (!mbi) return;
+    note_end((uint32_t)mbi + sizeof(*mbi));
+    if (mbi->flags & MULTIBOOT_INFO_CMDLINE) {
+        const char *c = (const char*)mbi->cmdline;
+        while (*c) c++;
+        note_end((uint32_t)c + 1);
+    }
+    if (!(mbi->flags & MULTIBOOT_INFO_MODS)) return;
+
+    const struct multiboot_module *mods = (const struct multiboot_module*)mbi->mods_addr;
+    note_end(mbi->mods_addr + mbi->mods_count * sizeof(*mods));
+    for (uint32_t i = 0; i < mbi->mods_count && nfiles < INITRD_MAX_FILES; i++) {
+        struct initrd_file *f = &files[nfiles++];
+        const char *cmd = mods[i].cmdline ? (const char*)mods[i].cmdline : "";
+        module_name(f->name, cmd);
+        f->data = (const uint8_t*)mods[i].mod_start;
+        f->size = mods[i].mod_end - mods[i].mod_start;
+        note_end(mods[i].mod_end);
+        const char *c = cmd;
+        while (*c) c++;
+        if (mods[i].cmdline) note_end((uint32_t)c + 1);
+    }
+}
+
+int initrd_count(void) { return nfiles; }
+
+const struct initrd_file *initrd_get(int i) {
+    return (i >= 0 && i < nfiles) ? &files[i] : 0;
+}
+
+const struct initrd_file *initrd_find(const char *name) {
+    for (int i = 0; i < nfiles; i++)
+        if (name_eq(files[i].name, name)) return &files[i];
+    return 0;
+}
+
+uint32_t initrd_end(void) { return end_addr; }
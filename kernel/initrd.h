@@ -0,0 +1,25 @@
+#ifndef INITRD_H
+#define INITRD_H
+#include <stdint.h>
+#include "multiboot.h"
+
+#define INITRD_MAX_FILES 16
+#define INITRD_NAME_MAX  32
+
+/* Um módulo multiboot; o nome é o último componente do caminho (ou o
+   segundo argumento da linha "module", se houver) */
+struct initrd_file {
+    char name[INITRD_NAME_MAX];
+    const uint8_t *data;
+    uint32_t size;
+};
+
+void initrd_init(const struct multiboot_info *mbi);
+int initrd_count(void);
+const struct initrd_file *initrd_get(int i);
+const struct initrd_file *initrd_find(const char *name);
+
+/* Primeiro endereço físico depois dos módulos e das strings do bootloader */
+uint32_t initrd_end(void);
+
+#endif
@@ -1,5 +1,6 @@
 // kernel/irq.c
 #include "idt.h"
+#include "irq.h"
 #include "util.h"
 #include <stdint.h>
 
@@ -70,8 +71,27 @@ void irq_install(void) {
 
 __attribute__((weak)) void on_irq(int irq) { (void)irq; }
 
-void irq_handler_c(int irq) {
-    on_irq(irq);        // chama o hook do dispositivo (ex.: teclado em irq == 1)
+static void (*irq_handlers[16])(void);
+
+void irq_install_handler(uint8_t irq, void (*handler)(void)) {
+    if (irq < 16) irq_handlers[irq] = handler;
+}
+
+void irq_unmask(uint8_t irq) {
+    uint16_t port = irq < 8 ? 0x21 : 0xA1;
+    outb(port, inb(port) & ~(1 << (irq & 7)));
+    if (irq >= 8) outb(0x21, inb(0x21) & ~(1 << 2)); // cascata do escravo
+}
+
+void irq_mask(uint8_t irq) {
+    uint16_t port = irq < 8 ? 0x21 : 0xA1;
+    outb(port, inb(port) | (1 << (irq & 7)));
+}
+
+/* "used": só é chamado pelo asm de irq_common, que o LTO não enxerga */
+__attribute__((used)) void irq_handler_c(int irq) {
+    if (irq_handlers[irq]) irq_handlers[irq]();
+    else on_irq(irq);   // chama o hook do dispositivo (ex.: teclado em irq == 1)
     // End Of Interrupt no PIC (escravo se irq>=8, depois mestre)
     if (irq >= 8) outb(0xA0, 0x20);
     outb(0x20, 0x20);
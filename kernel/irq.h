@@ -5,6 +5,8 @@
 
 void irq_install(void);
 void irq_unmask(uint8_t irq);
+void irq_mask(uint8_t irq);
+void irq_install_handler(uint8_t irq, void (*handler)(void)); // senão cai em on_irq()
 
 
 #endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "idt.h"
 #include "vga.h"
+#include "fpu.h"
 #include <stdint.h>
 
 /* Vamos padronizar: SEMPRE passamos para o handler comum
@@ -95,8 +96,15 @@ static const char *names[] = {
     "24","25","26","27","28","29","30","31"
 };
 
-void isr_handler_c(uint32_t int_no, uint32_t err_code) {
+/* "used": só é chamado pelo asm de isr_common, que o LTO não enxerga */
+__attribute__((used)) void isr_handler_c(uint32_t int_no, uint32_t err_code) {
     static int exc_count = 0;
+
+    /* #NM não é erro: é a troca preguiçosa do estado de FPU/SSE */
+    if (int_no == 7) {
+        fpu_nm_handler();
+        return;
+    }
     
     /* Evita loop infinito de exceções */
     if (++exc_count > 5) {
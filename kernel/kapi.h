@@ -0,0 +1,19 @@
+#ifndef KAPI_H
+#define KAPI_H
+#include <stdint.h>
+
+/* Interface entre o kernel e as aplicações carregadas do initrd.
+   A aplicação roda em ring 0 e recebe esta tabela no ponto de entrada. */
+#define KAPI_VERSION 1
+
+struct kapi {
+    uint32_t version;
+    void (*write)(const char *s);                          // texto no console
+    void (*putat)(char c, uint8_t color, int x, int y);    // célula na tela atual
+    int (*pop_char)(char *out);                            // teclado (1 se pegou)
+    void (*log)(const char *s);                            // serial
+};
+
+typedef int (*kapi_entry_t)(const struct kapi *k);
+
+#endif
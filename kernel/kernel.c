@@ -5,6 +5,18 @@
 #include "isr.h"
 #include "irq.h"
 #include "keyboard.h"
+#include "fpu.h"
+#include "multiboot.h"
+#include "serial.h"
+#include "fb.h"
+#include "gfx.h"
+#include "bench.h"
+#include "initrd.h"
+#include "paging.h"
+#include "elf.h"
+#include "kapi.h"
+#include "timer.h"
+#include "replay.h"
 #include "util.h"
 
 // Snake Game - Estruturas e variáveis
@@ -25,17 +37,60 @@ static int dx = 1, dy = 0; // direção inicial: direita
 static int game_running = 1;
 static int game_over = 0;
 static int game_started = 0; // Novo: controla se o jogo começou
-static uint32_t game_tick = 0;
-static uint32_t delay_counter = 0;
 static int speed_boost = 0; // Sistema de aceleração
-static uint32_t base_speed = 50; // Velocidade base
-static uint32_t boost_speed = 20; // Velocidade acelerada
+static uint32_t base_speed = 120; // Velocidade base (ms por passo)
+static uint32_t boost_speed = 50; // Velocidade acelerada (ms por passo)
+
+// Timers do jogo (roda hierárquica, callbacks no laço principal)
+static struct timer step_timer;  // passo da cobra
+static struct timer stats_timer; // log periódico das estatísticas dos timers
+static int step_redraw = 0;
+#define TIMER_STATS_MS 10000
+
+// Saída de vídeo: modo texto (padrão) ou grade de tiles no framebuffer
+static int use_gfx = 0;
+static const char *cmdline = "";
+
+#define BENCH_FRAMES 64
+
+// Gravação/reprodução das teclas ("record", "replay", "replay-rt")
+enum { REPLAY_OFF, REPLAY_FAST, REPLAY_RT };
+static int replay_mode = REPLAY_OFF;
+static int recording = 0;
+static uint32_t game_t0 = 0; // tick de início do jogo; eventos são relativos a ele
+
+// Tempos de move_snake e draw_world durante o replay (ciclos do TSC)
+#define REPLAY_SAMPLES 4096
+static uint32_t move_buf[REPLAY_SAMPLES], draw_buf[REPLAY_SAMPLES];
+static struct bench_samples move_samples = { .buf = move_buf, .cap = REPLAY_SAMPLES };
+static struct bench_samples draw_samples = { .buf = draw_buf, .cap = REPLAY_SAMPLES };
+
+// Semente da comida: fixada uma vez no boot (ou pela gravação), nunca lida do hardware no meio do jogo
+static uint32_t food_seed = 5381;
+
+static inline void put_cell(char c, uint8_t color, int x, int y) {
+    if (use_gfx) gfx_putat(c, color, x, y);
+    else vga_putat(c, color, x, y);
+}
+
+// Procura uma palavra na linha de comando do multiboot (ex.: "gfx", "bench")
+static int cmdline_has(const char *opt) {
+    const char *p = cmdline;
+    while (*p) {
+        while (*p == ' ') p++;
+        int i = 0;
+        while (opt[i] && p[i] == opt[i]) i++;
+        if (!opt[i] && (p[i] == ' ' || p[i] == 0)) return 1;
+        while (*p && *p != ' ') p++;
+    }
+    return 0;
+}
 
 static void draw_hud(void){
     // Desenha o HUD sempre na primeira linha (y=0) em posição fixa
     const char *msg = "JOGO DA COBRINHA — WASD/Setas: mover, Q: sair, R: reiniciar";
     for(int i=0; msg[i] && i<60; ++i) {
-        vga_putat(msg[i], 0x0A, i, 0);  // verde, linha 0
+        put_cell(msg[i], 0x0A, i, 0);  // verde, linha 0
     }
 }
 
@@ -56,14 +111,11 @@ static void init_snake(void) {
     game_over = 0;
     game_started = 0; // Começa pausado
     game_running = 1;
-    game_tick = 0; // Reset do timer também
-    delay_counter = 0;
     speed_boost = 0; // Reset do turbo
 }
 
 static void spawn_food(void) {
-    static uint32_t seed = 5381;
-    seed = ((seed << 5) + seed) + (inb(0x60) & 0xFF);
+    uint32_t seed = ((food_seed << 5) + food_seed) + 1;
     
     // Gera posição aleatória que não colida com a cobra
     do {
@@ -81,18 +133,19 @@ static void spawn_food(void) {
         }
         if(!collision) break;
     } while(1);
+    food_seed = seed;
 }
 
 static void draw_borders(void) {
     // Bordas horizontais
     for(int x = 0; x < 80; x++) {
-        vga_putat('#', 0x08, x, 1);  // topo
-        vga_putat('#', 0x08, x, 23); // baixo
+        put_cell('#', 0x08, x, 1);  // topo
+        put_cell('#', 0x08, x, 23); // baixo
     }
     // Bordas verticais
     for(int y = 1; y < 24; y++) {
-        vga_putat('#', 0x08, 0, y);  // esquerda
-        vga_putat('#', 0x08, 79, y); // direita
+        put_cell('#', 0x08, 0, y);  // esquerda
+        put_cell('#', 0x08, 79, y); // direita
     }
 }
 
@@ -100,7 +153,7 @@ static void draw_world(void){
     // Limpa a tela
     for(int y=0;y<25;y++) {
         for(int x=0;x<80;x++) {
-            vga_putat(' ',0x00,x,y);
+            put_cell(' ',0x00,x,y);
         }
     }
     
@@ -111,15 +164,15 @@ static void draw_world(void){
     for(int i = 0; i < snake_length; i++) {
         char c = (i == 0) ? 'O' : 'o'; // cabeça diferente do corpo
         uint8_t color = (i == 0) ? 0x0E : 0x0A; // cabeça amarela, corpo verde
-        vga_putat(c, color, snake[i].x, snake[i].y);
+        put_cell(c, color, snake[i].x, snake[i].y);
     }
     
     // Desenha a comida
-    vga_putat('*', 0x0C, food.x, food.y);
+    put_cell('*', 0x0C, food.x, food.y);
     
     // Score atual
     const char *label = "Pontos:";
-    for(int i=0; label[i]; ++i) vga_putat(label[i],0x0F,0+i,24);
+    for(int i=0; label[i]; ++i) put_cell(label[i],0x0F,0+i,24);
     
     // Converte score para string simples
     char score_str[10];
@@ -142,12 +195,12 @@ static void draw_world(void){
     }
     
     for(int i = 0; i < digits; i++) {
-        vga_putat(score_str[i], 0x0F, 8 + i, 24);
+        put_cell(score_str[i], 0x0F, 8 + i, 24);
     }
     
     // High Score
     const char *high_label = " | Recorde: ";
-    for(int i=0; high_label[i]; ++i) vga_putat(high_label[i],0x0B,9+i,24);
+    for(int i=0; high_label[i]; ++i) put_cell(high_label[i],0x0B,9+i,24);
     
     // Converte high score para string
     char high_str[10];
@@ -170,13 +223,13 @@ static void draw_world(void){
     }
     
     for(int i = 0; i < high_digits; i++) {
-        vga_putat(high_str[i], 0x0B, 21 + i, 24);
+        put_cell(high_str[i], 0x0B, 21 + i, 24);
     }
     
     // Indicador de velocidade
     if(speed_boost) {
         const char *speed_msg = " [TURBO!]";
-        for(int i=0; speed_msg[i]; ++i) vga_putat(speed_msg[i],0x0E,35+i,24);
+        for(int i=0; speed_msg[i]; ++i) put_cell(speed_msg[i],0x0E,35+i,24);
     }
     
     // Game Over message
@@ -184,7 +237,7 @@ static void draw_world(void){
         const char *msg = "FIM DE JOGO! Pressione R para reiniciar";
         int start_x = (80 - 39) / 2;
         for(int i = 0; msg[i]; i++) {
-            vga_putat(msg[i], 0x0C, start_x + i, 12);
+            put_cell(msg[i], 0x0C, start_x + i, 12);
         }
     }
     // Start message
@@ -194,12 +247,14 @@ static void draw_world(void){
         int start_x1 = (80 - 38) / 2;
         int start_x2 = (80 - 50) / 2;
         for(int i = 0; msg1[i]; i++) {
-            vga_putat(msg1[i], 0x0E, start_x1 + i, 11);
+            put_cell(msg1[i], 0x0E, start_x1 + i, 11);
         }
         for(int i = 0; msg2[i]; i++) {
-            vga_putat(msg2[i], 0x0A, start_x2 + i, 13);
+            put_cell(msg2[i], 0x0A, start_x2 + i, 13);
         }
     }
+
+    if (use_gfx) gfx_present();
 }
 
 static int check_collision(int new_x, int new_y) {
@@ -252,28 +307,274 @@ static void move_snake(void) {
     }
 }
 
-void kernel_main(void) {
+// Passo da cobra: roda em contexto adiado (timer_run), não no IRQ
+static void game_step(struct timer *t, void *arg) {
+    (void)arg;
+    if (!game_started || game_over) return;
+    if (replay_mode) {
+        uint64_t t0 = rdtsc();
+        move_snake();
+        bench_sample(&move_samples, rdtsc() - t0);
+    } else {
+        move_snake();
+    }
+    step_redraw = 1;
+
+    // TURBO ligou/desligou: reprograma o período
+    uint32_t period = TIMER_MS(speed_boost ? boost_speed : base_speed);
+    if (t->period != period) timer_arm(t, period, period);
+}
+
+static void log_timer_stats(struct timer *t, void *arg) {
+    (void)t; (void)arg;
+    const struct timer_stats *ts = timer_get_stats();
+    serial_write("[timer] ticks=");
+    serial_write_dec(ts->ticks);
+    serial_write(" disparos=");
+    serial_write_dec(ts->fired);
+    serial_write(" max/tick=");
+    serial_write_dec(ts->max_per_tick);
+    serial_write(" cascata=");
+    serial_write_dec(ts->cascaded);
+    serial_write(" folga_max=");
+    serial_write_dec(ts->slack_max);
+    serial_write(" folga_media=");
+    serial_write_dec(ts->fired ? ts->slack_total / ts->fired : 0);
+    serial_write("\n");
+}
+
+// Mede o custo de um quadro (move_snake + draw_world) no caminho de vídeo atual
+static void bench_frames(const char *avg_name, const char *max_name, int full_redraw) {
+    uint64_t total = 0, worst = 0;
+
+    init_snake();
+    spawn_food();
+    dx = 1; game_started = 1;
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        if (full_redraw && use_gfx) gfx_invalidate();
+        uint64_t t0 = rdtsc();
+        move_snake();
+        draw_world();
+        uint64_t t = rdtsc() - t0;
+        total += t;
+        if (t > worst) worst = t;
+        if (game_over) { init_snake(); dx = 1; game_started = 1; }
+    }
+    init_snake();
+
+    bench_report(avg_name, bench_cycles_to_us(total / BENCH_FRAMES), "us");
+    bench_report(max_name, bench_cycles_to_us(worst), "us");
+}
+
+static void run_benchmarks(void) {
+    bench_init();
+    bench_report("tsc", bench_tsc_khz(), "kHz");
+    bench_fpu();
+
+    use_gfx = 0;
+    bench_frames("text_frame_avg", "text_frame_max", 0);
+
+    if (!gfx_enter()) {
+        serial_write("BENCH framebuffer indisponivel\n");
+        return;
+    }
+    use_gfx = 1;
+    bench_fb();
+    bench_timers();
+    bench_frames("gfx_full_frame_avg", "gfx_full_frame_max", 1);
+    bench_frames("gfx_dirty_frame_avg", "gfx_dirty_frame_max", 0);
+
+    const struct gfx_stats *gs = gfx_get_stats();
+    bench_report("tile_hits", gs->tile_hits, "tiles");
+    bench_report("tile_misses", gs->tile_misses, "tiles");
+
+    const struct fb_stats *fs = fb_get_stats();
+    bench_report("fb_presents", fs->presents, "presents");
+    bench_report("fb_rects", fs->rects, "rects");
+    bench_report("fb_pixels", fs->pixels, "pixels");
+}
+
+// Nada a fazer até o próximo IRQ (tick ou tecla). Com as interrupções desligadas
+// reconfere o trabalho pendente; "sti; hlt" só aceita IRQs depois do hlt, então
+// um tick que chegue entre a checagem e o hlt não fica esperando o seguinte.
+static void idle_wait(void) {
+    __asm__ volatile ("cli" ::: "memory");
+    if (timer_due() || kbd_pending()) __asm__ volatile ("sti");
+    else __asm__ volatile ("sti; hlt");
+}
+
+// Quadro do laço principal; no replay, cronometrado
+static void draw_frame(void) {
+    if (replay_mode) {
+        uint64_t t0 = rdtsc();
+        draw_world();
+        bench_sample(&draw_samples, rdtsc() - t0);
+    } else {
+        draw_world();
+    }
+}
+
+// Escolhe o modo pela linha de comando e fixa a semente antes do primeiro spawn_food
+static void setup_replay(void) {
+    if (cmdline_has("replay") || cmdline_has("replay-rt")) {
+        const struct initrd_file *f = initrd_find("replay");
+        if (f && replay_load(f->data, f->size)) {
+            serial_write("[replay] modulo replay\n");
+        } else {
+            replay_load_builtin();
+            serial_write("[replay] gravacao embutida\n");
+        }
+        replay_mode = cmdline_has("replay-rt") ? REPLAY_RT : REPLAY_FAST;
+        food_seed = replay_seed();
+
+        // Só as teclas gravadas entram; a roda anda tick a tick pelo relógio manual
+        irq_mask(1);
+        timer_set_virtual(1);
+        if (!bench_tsc_khz()) bench_init();
+        return;
+    }
+
+    food_seed = (uint32_t)rdtsc() ^ inb(0x60);
+    if (cmdline_has("record")) {
+        recording = 1;
+        record_start(food_seed);
+    }
+}
+
+// Sem tecla nem quadro pendente: avança o relógio do replay (ou espera o IRQ)
+static void replay_idle(void) {
+    if (replay_done(timer_last_tick() - game_t0)) {
+        game_running = 0;
+        return;
+    }
+    // replay-rt: não passa à frente do relógio real
+    if (replay_mode == REPLAY_RT)
+        while ((int32_t)(timer_real_ticks() - timer_ticks()) <= 0) __asm__ volatile ("hlt");
+    timer_advance(1);
+}
+
+static void report_replay(uint64_t cycles) {
+    bench_report_percentiles("replay_move_snake", &move_samples);
+    bench_report_percentiles("replay_draw_world", &draw_samples);
+    bench_report("replay_frames", draw_samples.total, "frames");
+    bench_report("replay_steps", move_samples.total, "steps");
+    bench_report("replay_ticks", timer_last_tick() - game_t0, "ticks");
+    bench_report("replay_wall", bench_cycles_to_us(cycles), "us");
+    bench_report("replay_score", score > high_score ? score : high_score, "pts");
+}
+
+// Serviços expostos às aplicações do initrd
+static void kapi_putat(char c, uint8_t color, int x, int y) { put_cell(c, color, x, y); }
+
+static const struct kapi kapi_table = {
+    KAPI_VERSION, vga_write, kapi_putat, kbd_pop_char, serial_write,
+};
+
+// Carrega e executa cada módulo ELF do initrd; módulos que não são ELF são dados
+static void run_initrd_apps(void) {
+    for (int i = 0; i < initrd_count(); i++) {
+        const struct initrd_file *f = initrd_get(i);
+        struct elf_image img;
+        int err = elf_load(f->data, f->size, &img);
+        if (err == ELF_ERR_FORMAT) continue;
+
+        serial_write("[elf] ");
+        serial_write(f->name);
+        if (err) {
+            serial_write(": erro ");
+            serial_write_dec(-err);
+            serial_write("\n");
+            continue;
+        }
+        serial_write(": ");
+        serial_write_dec(img.pages_shared);
+        serial_write(" paginas sem copia, ");
+        serial_write_dec(img.pages_owned);
+        serial_write(" alocadas, ");
+        serial_write_dec(img.bytes_copied);
+        serial_write(" bytes copiados\n");
+
+        ((kapi_entry_t)img.entry)(&kapi_table);
+        elf_unload(&img);
+    }
+}
+
+void kernel_main(uint32_t magic, struct multiboot_info *mbi) {
+    if (magic != MULTIBOOT_BOOTLOADER_MAGIC) mbi = 0;
+    if (mbi && (mbi->flags & MULTIBOOT_INFO_CMDLINE)) cmdline = (const char*)mbi->cmdline;
+
+    serial_init();
     vga_init();
     vga_write("Iniciando IDT/IRQs...\n");
     idt_install();
     isr_install();
+    fpu_init();
+
+    // Módulos do GRUB viram o initrd; quadros livres começam depois deles
+    extern char _kernel_end[];
+    initrd_init(mbi);
+    uint32_t first_free = (uint32_t)_kernel_end;
+    if (initrd_end() > first_free) first_free = initrd_end();
+    uint64_t mem_top = (mbi && (mbi->flags & MULTIBOOT_INFO_MEMORY)) ? 0x100000 + (uint64_t)mbi->mem_upper * 1024 : 0;
+    // Quadros são acessados pelo endereço identidade, que na janela das aplicações é outro
+    if (mem_top > ELF_APP_BASE) mem_top = ELF_APP_BASE;
+    if (!paging_init(first_free, (uint32_t)mem_top)) vga_write("Sem PSE: paginacao desligada\n");
+
+    // Páginas dos módulos são compartilhadas com as aplicações: só leitura também na identidade
+    for (int i = 0; i < initrd_count(); i++) {
+        const struct initrd_file *f = initrd_get(i);
+        paging_protect((uint32_t)f->data, (uint32_t)f->data + f->size);
+    }
+
     irq_install();
+    timer_init();
     keyboard_init();
     __asm__ volatile ("sti");
 
+    vga_write(fpu_has_sse() ? "FPU/SSE habilitados (lazy)\n" : "FPU x87 habilitada (sem SSE)\n");
+    run_initrd_apps();
     vga_write("Pronto! Iniciando Jogo da Cobrinha...\n\n");
+
+    // Precisa da fonte VGA ainda em modo texto; sem modo texto, usa o framebuffer
+    int have_fb = gfx_init(mbi);
+    if (cmdline_has("bench")) {
+        run_benchmarks();
+        // "exit": encerra o QEMU (isa-debug-exit) para o make report seguir
+        if (cmdline_has("exit") && !cmdline_has("replay") && !cmdline_has("replay-rt")) {
+            outb(0xF4, 0);
+            for(;;) __asm__ volatile ("hlt");
+        }
+    }
+    if (have_fb && !use_gfx && (cmdline_has("gfx") || fb_from_bootloader()))
+        use_gfx = gfx_enter();
     
     // Inicializa o jogo
+    setup_replay();
     init_snake();
     spawn_food();
     draw_world();
 
+    timer_setup(&step_timer, game_step, 0);
+    // Uma só leitura do relógio: o primeiro passo fica preso ao início gravado
+    game_t0 = timer_ticks();
+    uint64_t replay_start = rdtsc();
+    timer_arm_at(&step_timer, game_t0 + TIMER_MS(base_speed), TIMER_MS(base_speed));
+    timer_setup(&stats_timer, log_timer_stats, 0);
+    timer_arm(&stats_timer, TIMER_MS(TIMER_STATS_MS), TIMER_MS(TIMER_STATS_MS));
+
     while (game_running) {
         char c;
         int redraw = 0;
+        int got_key = 0;
+
+        // Callbacks de timers vencidos (passo da cobra, log) rodam aqui
+        timer_run();
+        if (replay_mode) replay_inject(timer_last_tick() - game_t0);
         
         // Processa input do teclado
         if (kbd_pop_char(&c)) {
+            got_key = 1;
+            if (recording) record_key(timer_last_tick() - game_t0, c);
             if (c == 'q') {
                 // Atualiza high score antes de sair
                 if (score > high_score) {
@@ -315,35 +616,24 @@ void kernel_main(void) {
             }
         }
         
-        // Movimento automático da cobra com delay pesado
-        if (game_started && !game_over) {
-            delay_counter++;
-            
-            // Delay muito mais pesado - múltiplos loops
-            if (delay_counter >= 1000) {
-                delay_counter = 0;
-                
-                // Delay adicional com loops aninhados
-                for(volatile int i = 0; i < 10000; i++) {
-                    for(volatile int j = 0; j < 100; j++) {
-                        // Loop vazio para consumir ciclos de CPU
-                    }
-                }
-                
-                game_tick++;
-                uint32_t current_speed = speed_boost ? boost_speed : base_speed;
-                if (game_tick >= current_speed) {
-                    game_tick = 0;
-                    move_snake();
-                    redraw = 1;
-                }
-            }
+        if (step_redraw) {
+            step_redraw = 0;
+            redraw = 1;
         }
         
         if (redraw) {
-            draw_world();
+            draw_frame();
+        } else if (!got_key) {
+            if (replay_mode) replay_idle();
+            else idle_wait();
         }
     }
+
+    if (recording) record_dump(timer_last_tick() - game_t0);
+    if (replay_mode) {
+        report_replay(rdtsc() - replay_start);
+        if (cmdline_has("exit")) outb(0xF4, 0);
+    }
     
     vga_write("\nEncerrando Jogo da Cobrinha. Voce pressionou Q.\n");
     for(;;) __asm__ volatile ("hlt");
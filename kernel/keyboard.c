@@ -16,6 +16,8 @@ static const char scancode_to_ascii[128] = {
 
 static inline void push(char c){ int n=(head+1)&63; if(n!=tail){ fifo[head]=c; head=n; } }
 int kbd_pop_char(char *out){ if(tail==head) return 0; *out=fifo[tail]; tail=(tail+1)&63; return 1; }
+int kbd_pending(void){ return tail!=head; }
+void kbd_inject(char c){ push(c); }
 
 /* Handler real do teclado (IRQ1) */
 static void kbd_irq_handler(void) {
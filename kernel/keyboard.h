@@ -5,6 +5,8 @@
 
 void keyboard_init(void);
 int kbd_pop_char(char *out); // 1 se pegou, 0 se vazio
+int kbd_pending(void);       // 1 se há tecla no FIFO
+void kbd_inject(char c);     // entra no FIFO como se viesse da IRQ1 (replay)
 
 
 #endif
\ No newline at end of file
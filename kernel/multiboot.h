@@ -0,0 +1,46 @@
+#ifndef MULTIBOOT_H
+#define MULTIBOOT_H
+#include <stdint.h>
+
+/* Valor em EAX quando o bootloader é Multiboot (v1) */
+#define MULTIBOOT_BOOTLOADER_MAGIC 0x2BADB002
+
+/* Bits de multiboot_info.flags */
+#define MULTIBOOT_INFO_MEMORY      (1u << 0)
+#define MULTIBOOT_INFO_CMDLINE     (1u << 2)
+#define MULTIBOOT_INFO_MODS        (1u << 3)
+#define MULTIBOOT_INFO_FRAMEBUFFER (1u << 12)
+
+#define MULTIBOOT_FRAMEBUFFER_TYPE_RGB 1
+
+/* Estrutura entregue pelo bootloader em EBX (só os campos que usamos têm nome) */
+struct multiboot_info {
+    uint32_t flags;
+    uint32_t mem_lower, mem_upper;
+    uint32_t boot_device;
+    uint32_t cmdline;
+    uint32_t mods_count, mods_addr;
+    uint32_t syms[4];
+    uint32_t mmap_length, mmap_addr;
+    uint32_t drives_length, drives_addr;
+    uint32_t config_table;
+    uint32_t boot_loader_name;
+    uint32_t apm_table;
+    uint32_t vbe_control_info, vbe_mode_info;
+    uint16_t vbe_mode, vbe_interface_seg, vbe_interface_off, vbe_interface_len;
+    uint64_t framebuffer_addr;
+    uint32_t framebuffer_pitch;
+    uint32_t framebuffer_width, framebuffer_height;
+    uint8_t framebuffer_bpp;
+    uint8_t framebuffer_type;
+    uint8_t color_info[6];
+} __attribute__((packed));
+
+/* Entrada da lista em mods_addr; cmdline é a linha "module" do grub.cfg */
+struct multiboot_module {
+    uint32_t mod_start, mod_end;
+    uint32_t cmdline;
+    uint32_t reserved;
+} __attribute__((packed));
+
+#endif
@@ -0,0 +1,116 @@
+// kernel/paging.c — paginação: identidade com páginas de 4MB + mapeamentos de 4KB sob demanda
+#include "paging.h"
+#include "util.h"
+
+#define PDE_PS  0x080 // entrada de diretório aponta para página de 4MB
+#define CR0_PG  (1u << 31)
+#define CR0_WP  (1u << 16) // páginas só leitura valem também para o ring 0
+#define CR4_PSE (1u << 4)
+
+#define LARGE_PAGE 0x400000u
+
+static uint32_t page_dir[1024] __attribute__((aligned(4096)));
+static int enabled = 0;
+
+/* Quadros: pilha de liberados (encadeada dentro dos próprios quadros) + ponteiro que avança */
+static uint32_t next_frame, frames_end;
+static uint32_t free_list = 0;
+
+uint32_t frame_alloc(void) {
+    if (free_list) {
+        uint32_t f = free_list;
+        free_list = *(uint32_t*)f;
+        return f;
+    }
+    if (next_frame + PAGE_SIZE > frames_end) return 0;
+    uint32_t f = next_frame;
+    next_frame += PAGE_SIZE;
+    return f;
+}
+
+void frame_free(uint32_t phys) {
+    *(uint32_t*)phys = free_list;
+    free_list = phys;
+}
+
+static inline void invlpg(uint32_t virt) {
+    __asm__ volatile("invlpg (%0)" : : "r"(virt) : "memory");
+}
+
+/* Sem CPUID (386/486 antigos) não há como saber: trata como sem PSE */
+static int has_pse(void) {
+    uint32_t a, b, c, d;
+    if (!cpuid_supported()) return 0;
+    cpuid(1, &a, &b, &c, &d);
+    return (d >> 3) & 1;
+}
+
+int paging_init(uint32_t first_free, uint32_t mem_end) {
+    next_frame = (first_free + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    frames_end = mem_end & ~(PAGE_SIZE - 1);
+    if (!has_pse()) return 0;
+
+    for (uint32_t i = 0; i < 1024; i++)
+        page_dir[i] = (i * LARGE_PAGE) | PDE_PS | PAGE_WRITE | PAGE_PRESENT;
+
+    uint32_t cr0, cr4;
+    __asm__ volatile("mov %%cr4, %0" : "=r"(cr4));
+    __asm__ volatile("mov %0, %%cr4" : : "r"(cr4 | CR4_PSE));
+    __asm__ volatile("mov %0, %%cr3" : : "r"((uint32_t)page_dir));
+    __asm__ volatile("mov %%cr0, %0" : "=r"(cr0));
+    __asm__ volatile("mov %0, %%cr0" : : "r"(cr0 | CR0_PG | CR0_WP) : "memory");
+    enabled = 1;
+    return 1;
+}
+
+int paging_enabled(void) { return enabled; }
+
+/* Garante uma tabela de 4KB para a região de 4MB de virt */
+static uint32_t *page_table(uint32_t virt) {
+    uint32_t pdi = virt >> 22;
+    if (!(page_dir[pdi] & PDE_PS)) return (uint32_t*)(page_dir[pdi] & ~0xFFFu);
+
+    uint32_t *pt = (uint32_t*)frame_alloc();
+    if (!pt) return 0;
+    uint32_t base = page_dir[pdi] & ~(LARGE_PAGE - 1);
+    uint32_t flags = page_dir[pdi] & (PAGE_WRITE | PAGE_PRESENT);
+    for (uint32_t i = 0; i < 1024; i++)
+        pt[i] = (base + i * PAGE_SIZE) | flags;
+    page_dir[pdi] = (uint32_t)pt | PAGE_WRITE | PAGE_PRESENT;
+
+    /* A página grande saiu do diretório: recarrega CR3 para esvaziar o TLB */
+    uint32_t cr3;
+    __asm__ volatile("mov %%cr3, %0; mov %0, %%cr3" : "=r"(cr3) : : "memory");
+    return pt;
+}
+
+int paging_map(uint32_t virt, uint32_t phys, uint32_t flags) {
+    uint32_t *pt = page_table(virt);
+    if (!pt) return 0;
+    pt[(virt >> 12) & 0x3FF] = (phys & ~0xFFFu) | (flags & 0xFFF) | PAGE_PRESENT;
+    invlpg(virt);
+    return 1;
+}
+
+void paging_unmap(uint32_t virt) {
+    uint32_t pdi = virt >> 22;
+    if (page_dir[pdi] & PDE_PS) return;
+    uint32_t *pt = (uint32_t*)(page_dir[pdi] & ~0xFFFu);
+    pt[(virt >> 12) & 0x3FF] = 0;
+    invlpg(virt);
+}
+
+int paging_protect(uint32_t start, uint32_t end) {
+    if (!enabled) return 0;
+    for (uint32_t a = start & ~(PAGE_SIZE - 1); a < end; a += PAGE_SIZE)
+        if (!paging_map(a, a, 0)) return 0;
+    return 1;
+}
+
+uint32_t paging_lookup(uint32_t virt) {
+    uint32_t pde = page_dir[virt >> 22];
+    if (!(pde & PAGE_PRESENT)) return 0;
+    if (pde & PDE_PS) return (pde & ~(LARGE_PAGE - 1)) | (virt & (LARGE_PAGE - 1) & ~0xFFFu);
+    uint32_t pte = ((uint32_t*)(pde & ~0xFFFu))[(virt >> 12) & 0x3FF];
+    return (pte & PAGE_PRESENT) ? (pte & ~0xFFFu) : 0;
+}
@@ -0,0 +1,30 @@
+#ifndef PAGING_H
+#define PAGING_H
+#include <stdint.h>
+
+#define PAGE_SIZE 4096u
+
+#define PAGE_PRESENT 0x001
+#define PAGE_WRITE   0x002
+
+/* Liga a paginação com mapa identidade de 4GB em páginas de 4MB (PSE).
+   Quadros livres vêm de [first_free, mem_end). Retorna 0 se o CPU não tem PSE. */
+int paging_init(uint32_t first_free, uint32_t mem_end);
+int paging_enabled(void);
+
+/* Mapeia/desmapeia uma página de 4KB; a região de 4MB que a contém vira
+   uma tabela de páginas (preservando a identidade das demais páginas) */
+int paging_map(uint32_t virt, uint32_t phys, uint32_t flags);
+void paging_unmap(uint32_t virt);
+
+/* Remapeia [start, end) da identidade como só leitura (vale para o ring 0 via CR0.WP) */
+int paging_protect(uint32_t start, uint32_t end);
+
+/* Endereço físico da página de virt (0 se não mapeada) */
+uint32_t paging_lookup(uint32_t virt);
+
+/* Quadros físicos de 4KB; 0 quando a memória acaba */
+uint32_t frame_alloc(void);
+void frame_free(uint32_t phys);
+
+#endif
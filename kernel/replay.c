@@ -0,0 +1,106 @@
+// kernel/replay.c — gravação e reprodução determinística das teclas do jogo
+#include "replay.h"
+#include "keyboard.h"
+#include "serial.h"
+
+#define DUMP_BYTES_PER_LINE 32
+
+/* Sessão de demonstração: começa para a direita, faz um quadrado e liga o
+   TURBO; ticks de 1 ms */
+#define DEMO_EVENTS 7
+static const struct {
+    struct replay_header h;
+    struct replay_event ev[DEMO_EVENTS];
+} __attribute__((packed)) demo = {
+    { REPLAY_MAGIC, REPLAY_VERSION, 0, 0x00C0FFEE, 4000, DEMO_EVENTS },
+    {
+        {  200, 'd', {0} },
+        {  800, 's', {0} },
+        { 1400, 'a', {0} },
+        { 2000, 'w', {0} },
+        { 2600, 'd', {0} },
+        { 2700, 'd', {0} }, // mesma direção: TURBO
+        { 4000, 'q', {0} },
+    },
+};
+
+static const struct replay_header *play_hdr = 0;
+static const struct replay_event *play_ev = 0;
+static uint32_t play_next = 0;
+
+static struct replay_header rec_hdr;
+static struct replay_event rec_ev[REPLAY_MAX_EVENTS];
+static uint32_t rec_dropped = 0;
+
+int replay_load(const void *data, uint32_t size) {
+    const struct replay_header *h = (const struct replay_header*)data;
+    if (size < sizeof(*h) || h->magic != REPLAY_MAGIC || h->version != REPLAY_VERSION) return 0;
+    if (h->count > (size - sizeof(*h)) / sizeof(struct replay_event)) return 0;
+    play_hdr = h;
+    play_ev = (const struct replay_event*)(h + 1);
+    play_next = 0;
+    return 1;
+}
+
+void replay_load_builtin(void) { replay_load(&demo, sizeof(demo)); }
+
+uint32_t replay_seed(void) { return play_hdr ? play_hdr->seed : 0; }
+
+int replay_inject(uint32_t tick) {
+    int n = 0;
+    while (play_hdr && play_next < play_hdr->count &&
+           (int32_t)(play_ev[play_next].tick - tick) <= 0) {
+        kbd_inject((char)play_ev[play_next].key);
+        play_next++;
+        n++;
+    }
+    return n;
+}
+
+int replay_done(uint32_t tick) {
+    if (!play_hdr) return 1;
+    return play_next >= play_hdr->count && (int32_t)(tick - play_hdr->end_tick) >= 0;
+}
+
+void record_start(uint32_t seed) {
+    rec_hdr.magic = REPLAY_MAGIC;
+    rec_hdr.version = REPLAY_VERSION;
+    rec_hdr.reserved = 0;
+    rec_hdr.seed = seed;
+    rec_hdr.end_tick = 0;
+    rec_hdr.count = 0;
+    rec_dropped = 0;
+}
+
+void record_key(uint32_t tick, char key) {
+    if (rec_hdr.count >= REPLAY_MAX_EVENTS) { rec_dropped++; return; }
+    struct replay_event *e = &rec_ev[rec_hdr.count++];
+    e->tick = tick;
+    e->key = (uint8_t)key;
+    e->reserved[0] = e->reserved[1] = e->reserved[2] = 0;
+}
+
+static void dump_bytes(const uint8_t *p, uint32_t n, uint32_t *col) {
+    static const char hex[] = "0123456789abcdef";
+    for (uint32_t i = 0; i < n; i++) {
+        if (*col == 0) serial_write("REPLAY ");
+        serial_putc(hex[p[i] >> 4]);
+        serial_putc(hex[p[i] & 0xF]);
+        if (++*col == DUMP_BYTES_PER_LINE) { serial_putc('\n'); *col = 0; }
+    }
+}
+
+void record_dump(uint32_t end_tick) {
+    uint32_t col = 0;
+    rec_hdr.end_tick = end_tick;
+    if (rec_dropped) {
+        /* O resto da partida não foi gravado: o replay para onde a gravação parou */
+        serial_write("[replay] gravacao cheia, teclas descartadas: ");
+        serial_write_dec(rec_dropped);
+        serial_putc('\n');
+        rec_hdr.end_tick = rec_ev[REPLAY_MAX_EVENTS - 1].tick;
+    }
+    dump_bytes((const uint8_t*)&rec_hdr, sizeof(rec_hdr), &col);
+    dump_bytes((const uint8_t*)rec_ev, rec_hdr.count * sizeof(struct replay_event), &col);
+    if (col) serial_putc('\n');
+}
@@ -0,0 +1,50 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+#include <stdint.h>
+
+/* Formato (little endian), o mesmo do blob embutido, do módulo "replay"
+   e do que o modo record despeja na serial:
+   struct replay_header seguido de count x struct replay_event */
+#define REPLAY_MAGIC   0x594C5052 // "RPLY"
+#define REPLAY_VERSION 1
+
+/* Eventos guardados pelo modo record */
+#define REPLAY_MAX_EVENTS 1024
+
+struct replay_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t seed;      // semente do RNG da comida
+    uint32_t end_tick;  // tick em que a gravação terminou
+    uint32_t count;
+} __attribute__((packed));
+
+/* key entra no FIFO do teclado depois que a roda processou o tick */
+struct replay_event {
+    uint32_t tick;
+    uint8_t key;
+    uint8_t reserved[3];
+} __attribute__((packed));
+
+/* Valida e adota uma gravação; 0 se o blob é inválido */
+int replay_load(const void *data, uint32_t size);
+void replay_load_builtin(void);
+
+uint32_t replay_seed(void);
+
+/* Injeta no teclado os eventos com tick <= tick; retorna quantos */
+int replay_inject(uint32_t tick);
+
+/* 1 quando todos os eventos saíram e o relógio chegou ao fim da gravação */
+int replay_done(uint32_t tick);
+
+void record_start(uint32_t seed);
+void record_key(uint32_t tick, char key);
+
+/* Despeja a gravação na serial como linhas "REPLAY <hex>" (ver make record).
+   Teclas além de REPLAY_MAX_EVENTS são descartadas: o dump avisa e termina a
+   gravação no último evento guardado. */
+void record_dump(uint32_t end_tick);
+
+#endif
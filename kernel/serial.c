@@ -0,0 +1,32 @@
+// kernel/serial.c — COM1 para logs (qemu -serial stdio)
+#include "serial.h"
+#include "util.h"
+
+#define COM1 0x3F8
+
+void serial_init(void) {
+    outb(COM1 + 1, 0x00); /* sem interrupções */
+    outb(COM1 + 3, 0x80); /* DLAB para programar o divisor */
+    outb(COM1 + 0, 0x01); /* 115200 baud */
+    outb(COM1 + 1, 0x00);
+    outb(COM1 + 3, 0x03); /* 8N1 */
+    outb(COM1 + 2, 0xC7); /* FIFO ligada e limpa */
+    outb(COM1 + 4, 0x03); /* DTR + RTS */
+}
+
+void serial_putc(char c) {
+    if (c == '\n') serial_putc('\r');
+    while (!(inb(COM1 + 5) & 0x20)) { } /* espera o THR esvaziar */
+    outb(COM1, (uint8_t)c);
+}
+
+void serial_write(const char *s) {
+    while (*s) serial_putc(*s++);
+}
+
+void serial_write_dec(uint32_t v) {
+    char buf[11];
+    int n = 0;
+    do { buf[n++] = '0' + (v % 10); v /= 10; } while (v);
+    while (n) serial_putc(buf[--n]);
+}
@@ -0,0 +1,12 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+#include <stdint.h>
+
+
+void serial_init(void);
+void serial_putc(char c);
+void serial_write(const char *s);
+void serial_write_dec(uint32_t v);
+
+
+#endif
@@ -0,0 +1,206 @@
+// kernel/timer.c — PIT + roda de timers hierárquica (arm/cancel/expiração O(1))
+#include "timer.h"
+#include "irq.h"
+#include "util.h"
+
+#define PIT_HZ 1193182
+
+#define L0_SIZE (1u << TIMER_L0_BITS)
+#define LN_SIZE (1u << TIMER_LN_BITS)
+#define L0_MASK (L0_SIZE - 1)
+#define LN_MASK (LN_SIZE - 1)
+#define MAX_DELAY ((1u << (TIMER_L0_BITS + (TIMER_LEVELS - 1) * TIMER_LN_BITS)) - 1)
+
+static struct timer_link level0[L0_SIZE];
+static struct timer_link levels[TIMER_LEVELS - 1][LN_SIZE];
+
+static volatile uint32_t irq_ticks = 0; // escrito só pelo IRQ0
+static uint32_t wheel_now = 1;          // próximo tick que a roda vai processar
+static uint32_t virt_ticks = 0;         // relógio manual (replay determinístico)
+static int virtual_clock = 0;
+static int wheel_ready = 0;
+static int in_callback = 0;             // run_one_tick executando callbacks
+
+static struct timer_stats stats;
+
+/* ---------- listas circulares com sentinela ---------- */
+
+static inline void list_init(struct timer_link *l) { l->next = l->prev = l; }
+static inline int list_empty(const struct timer_link *l) { return l->next == l; }
+
+static inline void list_add_tail(struct timer_link *head, struct timer_link *n) {
+    n->prev = head->prev;
+    n->next = head;
+    head->prev->next = n;
+    head->prev = n;
+}
+
+static inline void list_del(struct timer_link *n) {
+    n->prev->next = n->next;
+    n->next->prev = n->prev;
+    n->next = n->prev = 0;
+}
+
+/* Move todos os elementos de from para to (vazia) */
+static inline void list_move_all(struct timer_link *from, struct timer_link *to) {
+    list_init(to);
+    if (list_empty(from)) return;
+    to->next = from->next;
+    to->prev = from->prev;
+    to->next->prev = to;
+    to->prev->next = to;
+    list_init(from);
+}
+
+/* Relógio que a roda segue: o do IRQ0 ou o manual */
+static inline uint32_t clock_now(void) { return virtual_clock ? virt_ticks : irq_ticks; }
+
+/* ---------- roda ---------- */
+
+static void wheel_init(void) {
+    for (uint32_t i = 0; i < L0_SIZE; i++) list_init(&level0[i]);
+    for (int l = 0; l < TIMER_LEVELS - 1; l++)
+        for (uint32_t i = 0; i < LN_SIZE; i++) list_init(&levels[l][i]);
+    wheel_ready = 1;
+}
+
+/* Escolhe o slot pelo quanto falta: quanto mais longe, mais grosso o nível */
+static void wheel_add(struct timer *t) {
+    uint32_t delta = t->expires - wheel_now;
+    struct timer_link *slot;
+
+    if ((int32_t)delta < 0) {
+        slot = &level0[wheel_now & L0_MASK]; // já venceu: próximo tick
+    } else if (delta < L0_SIZE) {
+        slot = &level0[t->expires & L0_MASK];
+    } else {
+        if (delta > MAX_DELAY) t->expires = wheel_now + MAX_DELAY;
+        int l = 0;
+        uint32_t shift = TIMER_L0_BITS;
+        while (l < TIMER_LEVELS - 2 && delta >= (1u << (shift + TIMER_LN_BITS))) {
+            l++;
+            shift += TIMER_LN_BITS;
+        }
+        slot = &levels[l][(t->expires >> shift) & LN_MASK];
+    }
+    list_add_tail(slot, &t->link);
+}
+
+/* Redistribui um slot de nível superior nos níveis abaixo; retorna o índice */
+static uint32_t cascade(int l, uint32_t index) {
+    struct timer_link work;
+    list_move_all(&levels[l][index], &work);
+    while (!list_empty(&work)) {
+        struct timer *t = (struct timer*)work.next;
+        list_del(&t->link);
+        wheel_add(t);
+        stats.cascaded++;
+    }
+    return index;
+}
+
+static void run_one_tick(void) {
+    uint32_t index = wheel_now & L0_MASK;
+
+    /* Nível 0 deu a volta: desce o próximo slot de cada nível, em cadeia */
+    if (index == 0) {
+        uint32_t shift = TIMER_L0_BITS;
+        for (int l = 0; l < TIMER_LEVELS - 1; l++, shift += TIMER_LN_BITS)
+            if (cascade(l, (wheel_now >> shift) & LN_MASK) != 0) break;
+    }
+
+    struct timer_link work;
+    list_move_all(&level0[index], &work);
+    wheel_now++;
+
+    uint32_t fired = 0;
+    uint32_t now = clock_now();
+    in_callback = 1;
+    while (!list_empty(&work)) {
+        struct timer *t = (struct timer*)work.next;
+        list_del(&t->link);
+
+        uint32_t slack = now - t->expires;
+        stats.slack_total += slack;
+        if (slack > stats.slack_max) stats.slack_max = slack;
+
+        /* Periódico: rearma antes do callback, que pode cancelar ou reprogramar */
+        if (t->period) {
+            t->expires += t->period;
+            wheel_add(t);
+        }
+        t->fn(t, t->arg);
+        fired++;
+    }
+    in_callback = 0;
+
+    stats.ticks++;
+    stats.fired += fired;
+    if (fired > stats.max_per_tick) stats.max_per_tick = fired;
+}
+
+/* ---------- API ---------- */
+
+static void timer_irq(void) { irq_ticks++; }
+
+void timer_init(void) {
+    if (!wheel_ready) wheel_init();
+
+    uint16_t divisor = PIT_HZ / TIMER_HZ;
+    outb(0x43, 0x34);                 // canal 0, lobyte/hibyte, modo 2 (rate generator)
+    outb(0x40, divisor & 0xFF);
+    outb(0x40, divisor >> 8);
+
+    irq_install_handler(0, timer_irq);
+    irq_unmask(0);
+}
+
+uint32_t timer_ticks(void) { return clock_now(); }
+uint32_t timer_real_ticks(void) { return irq_ticks; }
+uint32_t timer_last_tick(void) { return wheel_now - 1; }
+
+void timer_set_virtual(int on) {
+    if (on && !virtual_clock) virt_ticks = irq_ticks; // continua de onde o IRQ parou
+    virtual_clock = on;
+}
+
+void timer_advance(uint32_t n) { virt_ticks += n; }
+
+void timer_setup(struct timer *t, void (*fn)(struct timer *t, void *arg), void *arg) {
+    t->link.next = t->link.prev = 0;
+    t->expires = 0;
+    t->period = 0;
+    t->fn = fn;
+    t->arg = arg;
+}
+
+int timer_pending(const struct timer *t) { return t->link.next != 0; }
+
+void timer_arm(struct timer *t, uint32_t delay, uint32_t period) {
+    if (delay == 0) delay = 1;
+    /* Num callback, a partir do tick processado (ver timer.h) */
+    uint32_t base = in_callback ? wheel_now - 1 : clock_now();
+    timer_arm_at(t, base + delay, period);
+}
+
+void timer_arm_at(struct timer *t, uint32_t expires, uint32_t period) {
+    if (!wheel_ready) wheel_init();
+    if (timer_pending(t)) list_del(&t->link);
+    t->expires = expires;
+    t->period = period;
+    wheel_add(t);
+}
+
+void timer_cancel(struct timer *t) {
+    if (timer_pending(t)) list_del(&t->link);
+    t->period = 0;
+}
+
+void timer_run(void) {
+    /* O tick k é processado assim que o IRQ chega a k */
+    while ((int32_t)(clock_now() - wheel_now) >= 0) run_one_tick();
+}
+
+int timer_due(void) { return (int32_t)(clock_now() - wheel_now) >= 0; }
+
+const struct timer_stats *timer_get_stats(void) { return &stats; }
@@ -0,0 +1,76 @@
+#ifndef TIMER_H
+#define TIMER_H
+#include <stdint.h>
+
+/* Frequência do PIT (canal 0, IRQ0): 1 tick = 1 ms */
+#define TIMER_HZ 1000
+#define TIMER_MS(ms) ((uint32_t)(ms) * TIMER_HZ / 1000)
+
+/* Roda hierárquica: nível 0 com 256 slots de 1 tick, níveis 1..3 com 64
+   slots cada (granularidade 2^8, 2^14, 2^20 ticks). Alcance de 2^26 ticks;
+   prazos maiores são truncados. */
+#define TIMER_L0_BITS 8
+#define TIMER_LN_BITS 6
+#define TIMER_LEVELS  4
+
+struct timer_link {
+    struct timer_link *next, *prev;
+};
+
+struct timer {
+    struct timer_link link;  // deve ser o primeiro campo
+    uint32_t expires;        // tick absoluto
+    uint32_t period;         // 0 = one-shot
+    void (*fn)(struct timer *t, void *arg);
+    void *arg;
+};
+
+struct timer_stats {
+    uint32_t ticks;          // ticks processados pela roda
+    uint32_t fired;          // callbacks executados
+    uint32_t max_per_tick;   // maior número de disparos num único tick
+    uint32_t cascaded;       // timers redistribuídos entre níveis
+    uint32_t slack_total;    // soma de (tick do IRQ - expires) na hora do callback
+    uint32_t slack_max;
+};
+
+/* Programa o PIT e instala o handler de IRQ0 */
+void timer_init(void);
+
+/* Relógio dos timers (o do IRQ, ou o manual com timer_set_virtual) */
+uint32_t timer_ticks(void);
+
+/* Ticks contados pelo IRQ, mesmo com o relógio manual ligado */
+uint32_t timer_real_ticks(void);
+
+/* Último tick já processado por timer_run */
+uint32_t timer_last_tick(void);
+
+/* Relógio manual: o IRQ0 continua contando, mas a roda só anda com
+   timer_advance. Usado pelo replay para avançar tick a tick. */
+void timer_set_virtual(int on);
+void timer_advance(uint32_t n);
+
+void timer_setup(struct timer *t, void (*fn)(struct timer *t, void *arg), void *arg);
+
+/* Arma para daqui a delay ticks (mínimo 1); period > 0 torna periódico.
+   Rearmar um timer pendente o reprograma. O(1). Dentro de um callback o
+   atraso conta a partir do tick sendo processado, não do relógio (que pode
+   estar à frente se o laço atrasou): o replay reproduz a mesma fase. */
+void timer_arm(struct timer *t, uint32_t delay, uint32_t period);
+
+/* Como timer_arm, mas no tick absoluto expires (já vencido: próximo tick) */
+void timer_arm_at(struct timer *t, uint32_t expires, uint32_t period);
+void timer_cancel(struct timer *t);
+int timer_pending(const struct timer *t);
+
+/* Contexto adiado: avança a roda até o tick atual e executa os callbacks
+   vencidos. Chamado pelo laço principal, nunca de dentro de um IRQ. */
+void timer_run(void);
+
+/* 1 se há tick ainda não processado por timer_run */
+int timer_due(void);
+
+const struct timer_stats *timer_get_stats(void);
+
+#endif
@@ -12,6 +12,47 @@ uint8_t ret;
 __asm__ volatile ("inb %1, %0" : "=a"(ret) : "Nd"(port));
 return ret;
 }
+static inline void outw(uint16_t port, uint16_t val) {
+__asm__ volatile ("outw %0, %1" : : "a"(val), "Nd"(port));
+}
+static inline uint16_t inw(uint16_t port) {
+uint16_t ret;
+__asm__ volatile ("inw %1, %0" : "=a"(ret) : "Nd"(port));
+return ret;
+}
+static inline void outl(uint16_t port, uint32_t val) {
+__asm__ volatile ("outl %0, %1" : : "a"(val), "Nd"(port));
+}
+static inline uint32_t inl(uint16_t port) {
+uint32_t ret;
+__asm__ volatile ("inl %1, %0" : "=a"(ret) : "Nd"(port));
+return ret;
+}
+static inline uint64_t rdtsc(void) {
+uint32_t lo, hi;
+__asm__ volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+return ((uint64_t)hi << 32) | lo;
+}
+/* CPUID existe se o bit ID (21) do EFLAGS puder ser alternado */
+static inline int cpuid_supported(void) {
+uint32_t a, b;
+__asm__ volatile(
+"pushfl\n"
+"pushfl\n"
+"popl %0\n"
+"movl %0, %1\n"
+"xorl $0x200000, %0\n"
+"pushl %0\n"
+"popfl\n"
+"pushfl\n"
+"popl %0\n"
+"popfl\n"
+: "=&r"(a), "=&r"(b));
+return ((a ^ b) & 0x200000) != 0;
+}
+static inline void cpuid(uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx) {
+__asm__ volatile("cpuid" : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx) : "a"(leaf), "c"(0));
+}
 
 
 void *memset(void *dst, int c, size_t n);
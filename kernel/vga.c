@@ -55,4 +55,31 @@ while (*s) vga_putc(*s++);
 
 void vga_putat(char c, uint8_t color, int x, int y) {
 VGA_MEMORY[y*VGA_WIDTH + x] = vga_entry(c, color);
-}
\ No newline at end of file
+}
+
+// Lê a fonte do plano 2 da VRAM (32 bytes por glifo, usamos 16 linhas)
+void vga_font_read(uint8_t *out) {
+outb(0x3C4, 0x02); uint8_t seq2 = inb(0x3C5);
+outb(0x3C4, 0x04); uint8_t seq4 = inb(0x3C5);
+outb(0x3CE, 0x04); uint8_t gc4 = inb(0x3CF);
+outb(0x3CE, 0x05); uint8_t gc5 = inb(0x3CF);
+outb(0x3CE, 0x06); uint8_t gc6 = inb(0x3CF);
+
+// acesso linear ao plano 2 em 0xA0000
+outb(0x3C4, 0x02); outb(0x3C5, 0x04);
+outb(0x3C4, 0x04); outb(0x3C5, 0x06);
+outb(0x3CE, 0x04); outb(0x3CF, 0x02);
+outb(0x3CE, 0x05); outb(0x3CF, 0x00);
+outb(0x3CE, 0x06); outb(0x3CF, 0x04);
+
+const volatile uint8_t *plane2 = (const volatile uint8_t*)0xA0000;
+for (int c=0; c<256; ++c)
+for (int y=0; y<VGA_FONT_HEIGHT; ++y)
+out[c*VGA_FONT_HEIGHT + y] = plane2[c*32 + y];
+
+outb(0x3C4, 0x02); outb(0x3C5, seq2);
+outb(0x3C4, 0x04); outb(0x3C5, seq4);
+outb(0x3CE, 0x04); outb(0x3CF, gc4);
+outb(0x3CE, 0x05); outb(0x3CF, gc5);
+outb(0x3CE, 0x06); outb(0x3CF, gc6);
+}
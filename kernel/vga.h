@@ -5,6 +5,7 @@
 
 #define VGA_WIDTH 80
 #define VGA_HEIGHT 25
+#define VGA_FONT_HEIGHT 16
 
 
 void vga_init(void);
@@ -13,6 +14,7 @@ void vga_putc(char c);
 void vga_write(const char *s);
 void vga_putat(char c, uint8_t color, int x, int y);
 void vga_setcolor(uint8_t color);
+void vga_font_read(uint8_t *out); // 256 glifos x VGA_FONT_HEIGHT bytes
 
 
 #endif
\ No newline at end of file